@@ -0,0 +1,100 @@
+/*
+ *  @brief: Benchmark of the clustering of non-ground points. Labels the ground of every
+ *          frame of a directory (e.g. the 64-beam SqueezeSeg frames converted to text)
+ *          and times the SLR and voxel hash clustering on the non-ground points.
+ *  @file: benchCluster.cpp
+ */
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/filesystem.hpp>
+#include <chrono>
+
+#include "clustering.h"
+#include "groundExtractor.h"
+#include "pointCloud.h"
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+using namespace std;
+
+int main(int argc, char* argv[]) {
+
+	// Parse arguments
+	po::options_description description("Usage");
+	description.add_options()
+		("help", "Program usage.")
+		("inpath",    po::value<string>()->default_value("../data/sample/textfiles1/"), "Path to input point clouds.")
+		("cols",      po::value<int>()->default_value(512),  "Num. of azimuth columns of the ring grid.")
+		("repeat",    po::value<int>()->default_value(10),   "Num. of times every frame is clustered.")
+		("tolerance", po::value<float>()->default_value(0.5), "Max. distance between points of a voxel cluster.");
+	po::variables_map opts;
+	po::store(po::command_line_parser(argc, argv).options(description).run(), opts);
+	po::notify(opts);
+	if (opts.count("help")) {
+		cout << description;
+		return 1;
+	}
+	string inputPath = opts["inpath"].as<string>();
+	int numRepeats   = opts["repeat"].as<int>();
+
+	groundParams params;
+	params.numLPR      = 20;
+	params.numSegments = 4;
+	params.numIters    = 3;
+	params.seedThresh  = 1.2;
+	params.distThresh  = 0.3;
+	params.method      = true;
+	params.polarGrid   = false;
+
+	// Label the ground of every frame
+	vector<string> files;
+	if (!fs::is_directory(inputPath)) {
+		cerr << "Error: could not open " << inputPath << endl;
+		return 1;
+	}
+	for (fs::directory_iterator it(inputPath); it != fs::directory_iterator(); ++it) {
+		if (it->path().extension() == ".txt") files.push_back(it->path().string());
+	}
+	sort(files.begin(), files.end());
+	vector<vector<point_XYZIRL> > frames;
+	long numPoints = 0;
+	for (int f = 0; f < files.size(); f++) {
+		vector<point_XYZIRL> pointCloud;
+		vector<point_XYZIRL> labeledPointCloud;
+		if (!getPointCloud(files[f], pointCloud)) continue;
+		labelGroundPoints(pointCloud, labeledPointCloud, params);
+		orderPointCloud(labeledPointCloud);
+		frames.push_back(labeledPointCloud);
+		numPoints += labeledPointCloud.size();
+	}
+	cout << "  >> Frames: " << frames.size() << ", points: " << numPoints << endl;
+	if (frames.empty()) return 1;
+
+	// Time every clustering method
+	const char* names[] = { "slr", "voxel" };
+	ClusterMethod methods[] = { CLUSTER_SLR, CLUSTER_VOXEL };
+	for (int m = 0; m < 2; m++) {
+		clusterParams clustering;
+		clustering.method      = methods[m];
+		clustering.numColumns  = opts["cols"].as<int>();
+		clustering.runThresh   = 0.5;
+		clustering.mergeThresh = 1.0;
+		clustering.tolerance   = opts["tolerance"].as<float>();
+
+		long numClusters = 0;
+		vector<int> clusterIds;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (int r = 0; r < numRepeats; r++) {
+			for (int f = 0; f < frames.size(); f++) {
+				numClusters += clusterPoints(frames[f], clustering, clusterIds);
+			}
+		}
+		double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+		long numRuns = (long)numRepeats * frames.size();
+		cout << "  >> " << names[m] << ": " << elapsed / numRuns * 1000 << " ms/frame, "
+		     << numPoints * numRepeats / elapsed << " points/s, "
+		     << (double)numClusters / numRuns << " clusters/frame" << endl;
+	}
+	return 0;
+}
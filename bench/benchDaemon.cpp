@@ -0,0 +1,199 @@
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/filesystem.hpp>
+#include <iomanip>
+#include <chrono>
+
+#include "daemonClient.h"
+#include "pointCloud.h"
+
+/*
+ *  @brief: Latency benchmark of the segmentation daemon. Labels every frame of a
+ *          directory in process with a GroundSegmenter, then through a running daemon
+ *          (extractGround --daemon) one frame at a time and with --slots frames in
+ *          flight, and reports the latency percentiles of each and the throughput. The
+ *          algorithm options must match the ones the daemon was started with for the
+ *          labels to be compared.
+ *  @file: benchDaemon.cpp
+ */
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+using namespace std;
+
+// Value at a percentile of sorted samples
+double getPercentile(const vector<double>& sorted, double percentile) {
+	if (sorted.empty()) return 0;
+	size_t index = percentile / 100.0 * (sorted.size() - 1) + 0.5;
+	return sorted[min(index, sorted.size() - 1)];
+}
+
+// Milliseconds since a time point
+double elapsedMs(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+// Print the percentiles of a run
+void printLatency(string name, vector<double>& times, double totalMs, long numPoints) {
+	sort(times.begin(), times.end());
+	cout << fixed << setprecision(3) << setw(12) << name
+	     << setw(10) << getPercentile(times, 50) << setw(10) << getPercentile(times, 90)
+	     << setw(10) << getPercentile(times, 99) << setw(10) << times.back()
+	     << setw(14) << setprecision(0) << numPoints / (totalMs / 1000.0) << endl;
+}
+
+int main(int argc, char* argv[]) {
+
+	// Parse arguments
+	po::options_description description("Usage");
+	description.add_options()
+		("help", "Program usage.")
+		("socket",  po::value<string>()->default_value("/tmp/groundseg.sock"), "Unix socket of the daemon.")
+		("inpath",  po::value<string>()->default_value("../data/sample/textfiles1/"), "Path to input point clouds.")
+		("lpr",     po::value<int>()->default_value(20),    "Num. of seeds needed to get the LPR.")
+		("seg",     po::value<int>()->default_value(1),     "Num. of segments along the x-axis.")
+		("iter",    po::value<int>()->default_value(3),     "Num. of plane estimations per segment.")
+		("thseed",  po::value<float>()->default_value(1.2), "Max. value to determine a seed.")
+		("thdist",  po::value<float>()->default_value(0.3), "Max. value to determine ground distance.")
+		("method",  po::value<bool>()->default_value(true), "Use means or medians to extract seeds.")
+		("polar",   po::value<bool>()->default_value(false), "Segment on a polar grid instead of along the x-axis.")
+		("repeat",  po::value<int>()->default_value(20),    "Num. of times every frame is processed.")
+		("slots",   po::value<int>()->default_value(4),     "Frames in flight of the pipelined run.");
+	po::variables_map opts;
+	po::store(po::command_line_parser(argc, argv).options(description).run(), opts);
+	if (opts.count("help")) {
+		cout << description;
+		return 1;
+	}
+	try {
+		po::notify(opts);
+	} catch (exception& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+	string socketPath = opts["socket"].as<string>();
+	string inputPath  = opts["inpath"].as<string>();
+	int numRepeats    = max(1, opts["repeat"].as<int>());
+	int numSlots      = min(max(1, opts["slots"].as<int>()), DAEMON_MAX_SLOTS);
+
+	groundParams params;
+	params.numLPR      = opts["lpr"].as<int>();
+	params.numSegments = opts["seg"].as<int>();
+	params.numIters    = opts["iter"].as<int>();
+	params.seedThresh  = opts["thseed"].as<float>();
+	params.distThresh  = opts["thdist"].as<float>();
+	params.method      = opts["method"].as<bool>();
+	params.polarGrid   = opts["polar"].as<bool>();
+
+	// Read every frame once, labels are not part of the input sent to the daemon
+	vector<vector<point_XYZIRL> > frames;
+	if (!fs::is_directory(inputPath)) {
+		cerr << "Error: could not open " << inputPath << endl;
+		return 1;
+	}
+	vector<string> files;
+	for (fs::directory_iterator it(inputPath); it != fs::directory_iterator(); ++it) {
+		if (it->path().extension() == ".txt") files.push_back(it->path().string());
+	}
+	sort(files.begin(), files.end());
+	int maxPoints = 0;
+	long numPoints = 0;
+	for (int f = 0; f < files.size(); f++) {
+		frames.push_back(vector<point_XYZIRL>());
+		if (!getPointCloud(files[f], frames.back())) {
+			cerr << "Error: could not read " << files[f] << endl;
+			return 1;
+		}
+		maxPoints = max(maxPoints, (int)frames.back().size());
+		numPoints += frames.back().size();
+	}
+	if (frames.empty()) {
+		cerr << "Error: no frames in " << inputPath << endl;
+		return 1;
+	}
+	numPoints *= numRepeats;
+
+	// In process, on the same strided input the daemon gets
+	GroundSegmenter segmenter(params);
+	vector<vector<unsigned char> > expected(frames.size());
+	vector<float> xyz;
+	vector<double> localTimes;
+	double localTotal = 0;
+	for (int r = 0; r < numRepeats; r++) {
+		for (int f = 0; f < frames.size(); f++) {
+			xyz.resize(3 * frames[f].size());
+			for (int i = 0; i < frames[f].size(); i++) {
+				xyz[3 * i]     = frames[f][i].x;
+				xyz[3 * i + 1] = frames[f][i].y;
+				xyz[3 * i + 2] = frames[f][i].z;
+			}
+			expected[f].resize(frames[f].size());
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			segmenter.segment(&xyz[0], &xyz[1], &xyz[2], 3 * sizeof(float), frames[f].size(), &expected[f][0], NULL);
+			localTimes.push_back(elapsedMs(start));
+			localTotal += localTimes.back();
+		}
+	}
+
+	// Through the daemon, one frame at a time
+	DaemonClient client;
+	if (!client.connect(socketPath, numSlots, maxPoints)) {
+		cerr << "Error: could not connect to the daemon on " << socketPath << endl;
+		return 1;
+	}
+	vector<unsigned char> labels;
+	vector<double> roundTrips;
+	vector<double> daemonTimes;
+	double daemonTotal = 0;
+	long numDiffs = 0;
+	chrono::steady_clock::time_point runStart = chrono::steady_clock::now();
+	for (int r = 0; r < numRepeats; r++) {
+		for (int f = 0; f < frames.size(); f++) {
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			float time;
+			if (!client.submit(frames[f]) || client.wait(labels, &time) < 0) {
+				cerr << "Error: the daemon did not label the frame" << endl;
+				return 1;
+			}
+			roundTrips.push_back(elapsedMs(start));
+			daemonTimes.push_back(time);
+			daemonTotal += time;
+			if (r > 0) continue;
+			for (int i = 0; i < labels.size(); i++) numDiffs += labels[i] != expected[f][i];
+		}
+	}
+	double roundTripTotal = elapsedMs(runStart);
+
+	// Through the daemon, keeping the ring full
+	vector<double> pipelined;
+	vector<chrono::steady_clock::time_point> submitted;
+	runStart = chrono::steady_clock::now();
+	for (int n = 0; n < numRepeats * frames.size(); n++) {
+		if (client.getNumPending() == numSlots) {
+			if (client.wait(labels) < 0) break;
+			pipelined.push_back(elapsedMs(submitted[pipelined.size()]));
+		}
+		submitted.push_back(chrono::steady_clock::now());
+		if (!client.submit(frames[n % frames.size()])) break;
+	}
+	while (client.getNumPending() > 0 && client.wait(labels) >= 0) {
+		pipelined.push_back(elapsedMs(submitted[pipelined.size()]));
+	}
+	double pipelinedTotal = elapsedMs(runStart);
+	if (pipelined.size() != numRepeats * frames.size()) {
+		cerr << "Error: the daemon did not label every frame" << endl;
+		return 1;
+	}
+
+	// Report
+	cout << "  >> Frames: " << frames.size() << " x " << numRepeats << ", ring of " << numSlots << " slots" << endl << endl
+	     << setw(12) << "run" << setw(10) << "p50 ms" << setw(10) << "p90 ms" << setw(10) << "p99 ms" << setw(10) << "max ms"
+	     << setw(14) << "points/s" << endl;
+	printLatency("in process", localTimes, localTotal, numPoints);
+	printLatency("daemon", daemonTimes, daemonTotal, numPoints);
+	printLatency("round trip", roundTrips, roundTripTotal, numPoints);
+	printLatency("pipelined", pipelined, pipelinedTotal, numPoints);
+	cout << endl << "  >> Labels different from in process: " << numDiffs << endl;
+	return 0;
+}
@@ -0,0 +1,168 @@
+/*
+ *  @brief: Microbenchmarks of the public functions of groundExtractor.h and pointCloud.h
+ *          on random ground-like clouds. Every function is timed for every combination
+ *          of point count and seed count (comma separated, e.g. --points 1000,100000
+ *          --seeds 100,1000); functions that only take points ignore the seed count.
+ *  @file: benchFunctions.cpp
+ */
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/filesystem.hpp>
+#include <iomanip>
+#include <chrono>
+#include <random>
+
+#include "groundExtractor.h"
+#include "pointCloud.h"
+#include "optionList.h"
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+using namespace std;
+
+static volatile float sink; // Keeps the results of the timed calls alive
+
+// Random cloud: mostly ground around z = -1.7, some obstacles and mirror reflections
+void makeCloud(int numPoints, unsigned int seed, vector<point_XYZIRL>& pointCloud) {
+	mt19937 generator(seed);
+	uniform_real_distribution<float> position(-40.0, 40.0);
+	uniform_real_distribution<float> unit(0.0, 1.0);
+	normal_distribution<float> noise(0.0, 0.03);
+	pointCloud.resize(numPoints);
+	for (int i = 0; i < numPoints; i++) {
+		point_XYZIRL& p = pointCloud[i];
+		p.x = position(generator);
+		p.y = position(generator);
+		float kind = unit(generator);
+		if (kind < 0.7) p.z = -1.7 + 0.01 * p.x + noise(generator);  // Sloped ground
+		else if (kind < 0.99) p.z = -1.7 + 2.0 * unit(generator);     // Obstacles
+		else p.z = THRESH_ERROR - unit(generator);                      // Mirror reflections
+		p.i = unit(generator);
+		p.r = sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+		p.l = 0;
+		p.n = i;
+		p.h = NAN;
+		p.idx = i;
+	}
+}
+
+// Seconds per call, repeating the call for at least minTime seconds
+template <typename Setup, typename Call>
+double timeCall(Setup setup, Call call, double minTime) {
+	typedef chrono::steady_clock Clock;
+	double total = 0;
+	long numCalls = 0;
+	while (total < minTime || numCalls < 3) {
+		setup();
+		Clock::time_point start = Clock::now();
+		call();
+		total += chrono::duration<double>(Clock::now() - start).count();
+		numCalls++;
+	}
+	return total / numCalls;
+}
+
+// Print one row of the results
+void printRow(string name, int numPoints, int numSeeds, int numItems, double seconds) {
+	cout << setw(30) << left << name << right << setw(10) << numPoints << setw(8);
+	if (numSeeds > 0) cout << numSeeds;
+	else cout << "-";
+	cout << fixed << setprecision(3) << setw(14) << seconds * 1e6
+	     << setw(14) << numItems / seconds / 1e6 << endl;
+}
+
+int main(int argc, char* argv[]) {
+
+	// Parse arguments
+	po::options_description description("Usage");
+	description.add_options()
+		("help", "Program usage.")
+		("points",  po::value<string>()->default_value("1000,10000,100000"), "Point counts.")
+		("seeds",   po::value<string>()->default_value("20,1000"),          "Seed counts (also the num. of points of the LPR).")
+		("mintime", po::value<double>()->default_value(0.2),                "Min. time spent on every benchmark (s).");
+	po::variables_map opts;
+	po::store(po::command_line_parser(argc, argv).options(description).run(), opts);
+	if (opts.count("help")) {
+		cout << description;
+		return 1;
+	}
+	try {
+		po::notify(opts);
+	} catch (exception& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+	vector<int> pointCounts, seedCounts;
+	if (!parseList(opts["points"].as<string>(), pointCounts) || !parseList(opts["seeds"].as<string>(), seedCounts)) {
+		cerr << "Error: counts must be comma separated integers" << endl;
+		return 1;
+	}
+	double minTime = opts["mintime"].as<double>();
+
+	cout << setw(30) << left << "function" << right << setw(10) << "points" << setw(8) << "seeds"
+	     << setw(14) << "us/call" << setw(14) << "Mitems/s" << endl;
+	for (int p = 0; p < pointCounts.size(); p++) {
+		int numPoints = pointCounts[p];
+		vector<point_XYZIRL> cloud;
+		makeCloud(numPoints, numPoints, cloud);
+		vector<point_XYZIRL> work;
+		vector<point_XYZIRL> filtered;
+		vector<point_XYZIRL> sortedOnZ(cloud);
+		sortPointCloud(sortedOnZ, filtered, true, "z");
+
+		// Functions on the whole cloud
+		const char* axes[] = { "x", "z", "n" };
+		for (int a = 0; a < 3; a++) {
+			double seconds = timeCall([&]() { work = cloud; filtered.clear(); },
+			                          [&]() { sortPointCloud(work, filtered, a == 1, axes[a]); }, minTime);
+			printRow(string("sortPointCloud(") + axes[a] + (a == 1 ? ", filter)" : ")"), numPoints, 0, numPoints, seconds);
+		}
+		Eigen::MatrixXf normal(3, 1);
+		normal << 0.01, 0.0, 0.99995;
+		double seconds = timeCall([]() {}, [&]() {
+			float sum = 0;
+			for (int i = 0; i < cloud.size(); i++) sum += getDistance(convertPointToMatXf(cloud[i]), normal);
+			sink = sum;
+		}, minTime);
+		printRow("getDistance", numPoints, 0, numPoints, seconds);
+		seconds = timeCall([]() {}, [&]() {
+			float sum = 0;
+			for (int i = 0; i < cloud.size(); i++) sum += convertPointToMatXf(cloud[i])(0, 2);
+			sink = sum;
+		}, minTime);
+		printRow("convertPointToMatXf", numPoints, 0, numPoints, seconds);
+
+		// Reading a text frame
+		string tempFile = (fs::temp_directory_path() / fs::unique_path("benchFunctions-%%%%%%.txt")).string();
+		{
+			ofstream textfile(tempFile.c_str());
+			for (int i = 0; i < cloud.size(); i++) {
+				textfile << cloud[i].x << " " << cloud[i].y << " " << cloud[i].z << " " << cloud[i].i << " "
+				         << cloud[i].r << " " << cloud[i].l << " " << cloud[i].n << "\n";
+			}
+		}
+		seconds = timeCall([&]() { work.clear(); }, [&]() { getPointCloud(tempFile, work); }, minTime);
+		printRow("getPointCloud", numPoints, 0, numPoints, seconds);
+		fs::remove(tempFile);
+
+		// Functions parameterized by the seed count
+		for (int s = 0; s < seedCounts.size(); s++) {
+			int numSeeds = min(seedCounts[s], numPoints);
+			vector<point_XYZIRL> seeds(sortedOnZ.begin(), sortedOnZ.begin() + numSeeds);
+			for (int method = 1; method >= 0; method--) {
+				seconds = timeCall([&]() { work.clear(); },
+				                   [&]() { extractInitialSeedPoints(sortedOnZ, work, numSeeds, 1.2, method); }, minTime);
+				printRow(method ? "extractInitialSeedPoints(mean)" : "extractInitialSeedPoints(med)", numPoints, numSeeds, numPoints, seconds);
+			}
+			Eigen::MatrixXf means;
+			seconds = timeCall([]() {}, [&]() { means = getSeedMeans(seeds); }, minTime);
+			printRow("getSeedMeans", numPoints, numSeeds, numSeeds, seconds);
+			seconds = timeCall([]() {}, [&]() { sink = getSeedMedians(seeds)(2, 0); }, minTime);
+			printRow("getSeedMedians", numPoints, numSeeds, numSeeds, seconds);
+			seconds = timeCall([]() {}, [&]() { sink = estimatePlaneNormal(seeds, means)(2, 0); }, minTime);
+			printRow("estimatePlaneNormal", numPoints, numSeeds, numSeeds, seconds);
+		}
+	}
+	return 0;
+}
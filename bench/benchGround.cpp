@@ -0,0 +1,300 @@
+/*
+ *  @brief: Regression benchmark of the ground labeling. Runs the whole pipeline of
+ *          extractGround (read, drop zero padding, label, restore input order, cluster)
+ *          on every frame of a directory and reports the throughput, the latency
+ *          percentiles of every stage, the peak memory and the precision/recall of the
+ *          ground against the labels of the input (points labeled 4). With --golden
+ *          the labels are compared with the label files of a golden directory and the
+ *          benchmark fails if they differ in more than --maxdiff of the points;
+ *          --update writes the current labels as the new golden files. Built with
+ *          GLA_ALLOC_TRACK, the allocations of every stage are reported too and the
+ *          benchmark fails if a frame exceeds the --maxallocs, --maxbytes or --maxpeak
+ *          budgets.
+ *  @file: benchGround.cpp
+ */
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/filesystem.hpp>
+#include <sys/resource.h>
+#include <iomanip>
+#include <chrono>
+
+#include "clustering.h"
+#include "groundExtractor.h"
+#include "groundEvaluation.h"
+#include "pointCloud.h"
+#include "allocTracker.h"
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+using namespace std;
+
+enum BenchStage { STAGE_READ, STAGE_COMPACT, STAGE_LABEL, STAGE_ORDER, STAGE_CLUSTER, NUM_STAGES };
+static const char* STAGE_NAMES[NUM_STAGES] = { "read", "compact", "label", "order", "cluster" };
+
+// Value at a percentile of sorted samples
+double getPercentile(const vector<double>& sorted, double percentile) {
+	if (sorted.empty()) return 0;
+	size_t index = percentile / 100.0 * (sorted.size() - 1) + 0.5;
+	return sorted[min(index, sorted.size() - 1)];
+}
+
+// Allocations since a snapshot of the totals, and peak since the last reset
+allocStats allocationsSince(const allocStats& start) {
+	allocStats stats;
+	getAllocationTotals(stats);
+	stats.allocations -= start.allocations;
+	stats.bytes -= start.bytes;
+	return stats;
+}
+
+// Milliseconds since a time point
+double elapsedMs(chrono::steady_clock::time_point start) {
+	return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char* argv[]) {
+
+	// Parse arguments
+	po::options_description description("Usage");
+	description.add_options()
+		("help", "Program usage.")
+		("inpath",  po::value<string>()->default_value("../data/synthetic/"), "Path to input point clouds, e.g. written by makeScene.")
+		("lpr",     po::value<int>()->default_value(20),    "Num. of seeds needed to get the LPR.")
+		("seg",     po::value<int>()->default_value(1),     "Num. of segments along the x-axis.")
+		("iter",    po::value<int>()->default_value(3),     "Num. of plane estimations per segment.")
+		("thseed",  po::value<float>()->default_value(1.2), "Max. value to determine a seed.")
+		("thdist",  po::value<float>()->default_value(0.3), "Max. value to determine ground distance.")
+		("method",  po::value<bool>()->default_value(true), "Use means or medians to extract seeds.")
+		("polar",   po::value<bool>()->default_value(false), "Segment on a polar grid instead of along the x-axis.")
+		("cluster", po::value<string>()->default_value("none"), "Cluster non-ground points: none, slr, voxel.")
+		("cols",    po::value<int>()->default_value(512),   "Num. of azimuth columns of the ring grid.")
+		("repeat",  po::value<int>()->default_value(5),     "Num. of times every frame is processed.")
+		("golden",  po::value<string>()->default_value(""), "Directory with the golden label files.")
+		("update",  po::value<bool>()->default_value(false), "Save the labels as the new golden files.")
+		("maxdiff", po::value<double>()->default_value(0.0), "Max. fraction of points whose label may differ from the golden one.")
+		("maxallocs", po::value<long>()->default_value(0),  "Max. allocations per frame, 0 for no budget (GLA_ALLOC_TRACK builds).")
+		("maxbytes", po::value<long>()->default_value(0),   "Max. bytes allocated per frame, 0 for no budget.")
+		("maxpeak", po::value<long>()->default_value(0),    "Max. live heap bytes during a frame, 0 for no budget.");
+	po::variables_map opts;
+	po::store(po::command_line_parser(argc, argv).options(description).run(), opts);
+	if (opts.count("help")) {
+		cout << description;
+		return 1;
+	}
+	try {
+		po::notify(opts);
+	} catch (exception& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+	string inputPath  = opts["inpath"].as<string>();
+	string goldenPath = opts["golden"].as<string>();
+	bool update       = opts["update"].as<bool>();
+	double maxDiff    = opts["maxdiff"].as<double>();
+	int numRepeats    = max(1, opts["repeat"].as<int>());
+	long maxAllocs    = opts["maxallocs"].as<long>();
+	long maxBytes     = opts["maxbytes"].as<long>();
+	long maxPeak      = opts["maxpeak"].as<long>();
+	if (!ALLOC_TRACKED() && (maxAllocs || maxBytes || maxPeak)) {
+		cerr << "Error: allocation budgets need a build with cmake -DGLA_ALLOC_TRACK=ON" << endl;
+		return 1;
+	}
+
+	groundParams params;
+	params.numLPR      = opts["lpr"].as<int>();
+	params.numSegments = opts["seg"].as<int>();
+	params.numIters    = opts["iter"].as<int>();
+	params.seedThresh  = opts["thseed"].as<float>();
+	params.distThresh  = opts["thdist"].as<float>();
+	params.method      = opts["method"].as<bool>();
+	params.polarGrid   = opts["polar"].as<bool>();
+
+	clusterParams clustering;
+	clustering.numColumns  = opts["cols"].as<int>();
+	clustering.runThresh   = 0.5;
+	clustering.mergeThresh = 1.0;
+	clustering.tolerance   = 0.5;
+	if (!parseClusterMethod(opts["cluster"].as<string>(), clustering.method)) {
+		cerr << "Error: unknown clustering method " << opts["cluster"].as<string>() << endl;
+		return 1;
+	}
+
+	vector<string> files;
+	if (!fs::is_directory(inputPath)) {
+		cerr << "Error: could not open " << inputPath << endl;
+		return 1;
+	}
+	for (fs::directory_iterator it(inputPath); it != fs::directory_iterator(); ++it) {
+		if (it->path().extension() == ".txt") files.push_back(it->path().string());
+	}
+	sort(files.begin(), files.end());
+	if (files.empty()) {
+		cerr << "Error: no frames in " << inputPath << endl;
+		return 1;
+	}
+	if (update && goldenPath.empty()) {
+		cerr << "Error: --update needs a --golden directory" << endl;
+		return 1;
+	}
+	if (update) fs::create_directories(goldenPath);
+
+	// Run the pipeline on every frame
+	vector<double> stageTimes[NUM_STAGES];
+	long long stageAllocs[NUM_STAGES] = {0};
+	long long stageBytes[NUM_STAGES] = {0};
+	allocStats maxFrame;
+	memset(&maxFrame, 0, sizeof(maxFrame));
+	groundScore score;
+	memset(&score, 0, sizeof(score));
+	long numPoints = 0;
+	long numDiffs = 0;
+	long numCompared = 0;
+	int numMissing = 0;
+	double totalTime = 0;
+	for (int f = 0; f < files.size(); f++) {
+		for (int r = 0; r < numRepeats; r++) {
+			vector<point_XYZIRL> pointCloud;
+			vector<point_XYZIRL> labeledPointCloud;
+			vector<point_XYZIRL> emptyPoints;
+			vector<unsigned char> truth;
+			vector<int> clusterIds;
+			double times[NUM_STAGES];
+			allocStats allocations[NUM_STAGES];
+			allocStats allocStart;
+			resetAllocationPeak();
+
+			getAllocationTotals(allocStart);
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			if (!getPointCloud(files[f], pointCloud)) {
+				cerr << "Error: could not read " << files[f] << endl;
+				return 1;
+			}
+			times[STAGE_READ] = elapsedMs(start);
+			allocations[STAGE_READ] = allocationsSince(allocStart);
+			extractGroundTruth(pointCloud, truth); // Not timed
+
+			getAllocationTotals(allocStart);
+			start = chrono::steady_clock::now();
+			compactPointCloud(pointCloud, emptyPoints);
+			times[STAGE_COMPACT] = elapsedMs(start);
+			allocations[STAGE_COMPACT] = allocationsSince(allocStart);
+
+			getAllocationTotals(allocStart);
+			start = chrono::steady_clock::now();
+			labelGroundPoints(pointCloud, labeledPointCloud, params);
+			times[STAGE_LABEL] = elapsedMs(start);
+			allocations[STAGE_LABEL] = allocationsSince(allocStart);
+
+			getAllocationTotals(allocStart);
+			start = chrono::steady_clock::now();
+			restorePointCloud(labeledPointCloud, emptyPoints);
+			orderPointCloud(labeledPointCloud);
+			times[STAGE_ORDER] = elapsedMs(start);
+			allocations[STAGE_ORDER] = allocationsSince(allocStart);
+
+			getAllocationTotals(allocStart);
+			start = chrono::steady_clock::now();
+			clusterPoints(labeledPointCloud, clustering, clusterIds);
+			times[STAGE_CLUSTER] = elapsedMs(start);
+			allocations[STAGE_CLUSTER] = allocationsSince(allocStart);
+
+			allocStats frame;
+			memset(&frame, 0, sizeof(frame));
+			for (int s = 0; s < NUM_STAGES; s++) {
+				stageTimes[s].push_back(times[s]);
+				totalTime += times[s];
+				stageAllocs[s] += allocations[s].allocations;
+				stageBytes[s] += allocations[s].bytes;
+				frame.allocations += allocations[s].allocations;
+				frame.bytes += allocations[s].bytes;
+			}
+			maxFrame.allocations = max(maxFrame.allocations, frame.allocations);
+			maxFrame.bytes = max(maxFrame.bytes, frame.bytes);
+			maxFrame.peakBytes = max(maxFrame.peakBytes, allocations[STAGE_CLUSTER].peakBytes);
+			numPoints += truth.size();
+			if (r > 0) continue;
+
+			// Accuracy and regression checks, once per frame
+			scoreGroundLabels(labeledPointCloud, truth, score);
+			if (goldenPath.empty()) continue;
+			string goldenFile = (fs::path(goldenPath) / fs::path(files[f]).stem()).string() + ".labels";
+			if (update) {
+				saveLabels(labeledPointCloud, goldenFile, false);
+				continue;
+			}
+			vector<unsigned char> golden;
+			if (!getLabels(goldenFile, false, golden)) {
+				numMissing++;
+				continue;
+			}
+			size_t size = max(golden.size(), labeledPointCloud.size());
+			for (size_t i = 0; i < size; i++) {
+				if (i >= golden.size() || i >= labeledPointCloud.size() || golden[i] != (unsigned char)labeledPointCloud[i].l) numDiffs++;
+			}
+			numCompared += size;
+		}
+	}
+
+	// Report
+	cout << "  >> Frames: " << files.size() << " x " << numRepeats << ", points: " << numPoints / numRepeats << endl
+	     << "  >> Throughput: " << numPoints / (totalTime / 1000.0) << " points/s, "
+	     << totalTime / (files.size() * numRepeats) << " ms/frame" << endl << endl
+	     << setw(10) << "stage" << setw(10) << "p50 ms" << setw(10) << "p90 ms" << setw(10) << "p99 ms" << setw(10) << "max ms" << endl;
+	for (int s = 0; s < NUM_STAGES; s++) {
+		sort(stageTimes[s].begin(), stageTimes[s].end());
+		cout << fixed << setprecision(3) << setw(10) << STAGE_NAMES[s]
+		     << setw(10) << getPercentile(stageTimes[s], 50) << setw(10) << getPercentile(stageTimes[s], 90)
+		     << setw(10) << getPercentile(stageTimes[s], 99) << setw(10) << stageTimes[s].back() << endl;
+	}
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	cout << endl << "  >> Peak RSS: " << usage.ru_maxrss / 1024.0 << " MB" << endl
+	     << "  >> Ground precision: " << getPrecision(score) << ", recall: " << getRecall(score)
+	     << (score.truePositives + score.falseNegatives == 0 ? " (no ground truth labels)" : "") << endl;
+
+	// Allocation budgets
+	if (ALLOC_TRACKED()) {
+		long numRuns = files.size() * numRepeats;
+		cout << endl << setw(10) << "stage" << setw(14) << "allocs/frame" << setw(14) << "MB/frame" << endl;
+		for (int s = 0; s < NUM_STAGES; s++) {
+			cout << setw(10) << STAGE_NAMES[s] << setw(14) << stageAllocs[s] / numRuns
+			     << setw(14) << stageBytes[s] / numRuns / 1048576.0 << endl;
+		}
+		cout << endl << "  >> Max. per frame: " << maxFrame.allocations << " allocations, "
+		     << maxFrame.bytes / 1048576.0 << " MB allocated, " << maxFrame.peakBytes / 1048576.0 << " MB peak heap" << endl;
+		bool overBudget = false;
+		if (maxAllocs && maxFrame.allocations > maxAllocs) {
+			cout << "FAILED: " << maxFrame.allocations << " allocations per frame, budget " << maxAllocs << endl;
+			overBudget = true;
+		}
+		if (maxBytes && maxFrame.bytes > maxBytes) {
+			cout << "FAILED: " << maxFrame.bytes << " bytes allocated per frame, budget " << maxBytes << endl;
+			overBudget = true;
+		}
+		if (maxPeak && maxFrame.peakBytes > maxPeak) {
+			cout << "FAILED: " << maxFrame.peakBytes << " bytes of peak heap per frame, budget " << maxPeak << endl;
+			overBudget = true;
+		}
+		if (overBudget) return 1;
+	}
+
+	if (goldenPath.empty()) return 0;
+	if (update) {
+		cout << "  >> Golden labels saved in " << goldenPath << endl;
+		return 0;
+	}
+	double diffRatio = numCompared > 0 ? (double)numDiffs / numCompared : 0;
+	cout << "  >> Labels different from golden: " << numDiffs << " / " << numCompared << " (" << diffRatio * 100 << "%)" << endl;
+	if (numMissing > 0) {
+		cout << "FAILED: " << numMissing << " frames without golden labels" << endl;
+		return 1;
+	}
+	if (diffRatio > maxDiff) {
+		cout << "FAILED: labels diverge from golden beyond " << maxDiff * 100 << "%" << endl;
+		return 1;
+	}
+	cout << "  >> Golden check passed" << endl;
+	return 0;
+}
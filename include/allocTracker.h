@@ -0,0 +1,62 @@
+#ifndef ALLOCTRACKER_H
+#define ALLOCTRACKER_H
+
+#define MAX_ALLOC_SCOPES 16 // Scopes allocations are attributed to, e.g. the pipeline stages
+#define NO_ALLOC_SCOPE -1
+
+/*
+ *	Allocation tracking is only compiled with -DGLA_ALLOC_TRACK (cmake -DGLA_ALLOC_TRACK=ON):
+ *  malloc, calloc, realloc, free and the aligned allocations are then replaced by
+ *  counting wrappers of the glibc allocator, so operator new, the containers and the
+ *  Eigen matrices are all counted. Bytes are the usable size of the blocks.
+ */
+#ifdef GLA_ALLOC_TRACK
+#define ALLOC_TRACKED() true
+#else
+#define ALLOC_TRACKED() false
+#endif
+
+struct allocStats {
+	long long allocations;  // Num. of blocks allocated
+	long long bytes;        // Bytes allocated
+	long long peakBytes;    // Max. live bytes of the process
+};
+
+/*
+ *	Sets the scope the allocations of the calling thread are attributed to.
+ *
+ *  @params
+ *  	scope, NO_ALLOC_SCOPE for none (int)
+ *  @return previous scope (int)
+ */
+int setAllocationScope(int scope);
+
+/*
+ *	Gets the allocations made in a scope since the start of the process, and the
+ *  max. live bytes reached by an allocation of the scope.
+ *
+ *  @params
+ *  	scope (int)
+ * 		reference to statistics (allocStats)
+ *  @return void
+ */
+void getAllocationStats(int scope, allocStats& stats);
+
+/*
+ *	Gets the allocations of the whole process since its start, and the max. live
+ *  bytes since the last call to resetAllocationPeak.
+ *
+ *  @params
+ * 		reference to statistics (allocStats)
+ *  @return void
+ */
+void getAllocationTotals(allocStats& stats);
+
+/*
+ *	Restarts the peak of getAllocationTotals from the bytes live now.
+ *
+ *  @return void
+ */
+void resetAllocationPeak();
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include "manifest.h"
+#include <map>
+
+#define CHECKPOINT_READ_SIZE (1 << 20)  // Bytes read at once to hash a file
+
+/*
+ *	Checkpoint of a resumable run: a tab-separated file in the output directory with a
+ *  line per labeled input, appended and flushed as soon as its output is saved. An
+ *  input is done if its content and the options the output depends on hash the same
+ *  as when it was labeled, and its output still exists. A later line of the same input
+ *  replaces the earlier ones.
+ */
+
+struct checkpointEntry {
+	manifestEntry frame;      // Input, output and statistics of the run that labeled it
+	std::string contentHash;  // Hash of the input file
+	std::string paramsHash;   // Hash of the options the output depends on
+};
+
+/*
+ *	Gets the hash of the content of a file.
+ *
+ *  @params
+ *  	file path (string)
+ * 		reference to the hash, 16 hex digits (string)
+ *  @return 1 if successful, 0 if the file can not be read
+ */
+int getFileHash(std::string path, std::string& hash);
+
+/*
+ *	Gets the hash of a text, e.g. of the options of a run.
+ *
+ *  @params
+ *  	text (string)
+ *  @return hash, 16 hex digits (string)
+ */
+std::string getTextHash(const std::string& text);
+
+/*
+ *	Reads a checkpoint. A missing file is an empty checkpoint, and a last line cut short
+ *  by a dying run is ignored.
+ *
+ *  @params
+ *  	checkpoint path (string)
+ * 		reference to the entry of every input (map<string, checkpointEntry>)
+ *  @return 1 if successful, 0 if it can not be read
+ */
+int readCheckpoint(std::string path, std::map<std::string, checkpointEntry>& entries);
+
+/*
+ *	Rewrites a checkpoint with a line per input, replacing it atomically.
+ *
+ *  @params
+ *  	checkpoint path (string)
+ * 		entry of every input (map<string, checkpointEntry>)
+ *  @return 1 if successful, 0 if not
+ */
+int saveCheckpoint(std::string path, const std::map<std::string, checkpointEntry>& entries);
+
+/*
+ *	Appends the entry of an input just labeled to a checkpoint.
+ *
+ *  @params
+ *  	checkpoint path (string)
+ * 		entry (checkpointEntry)
+ *  @return 1 if successful, 0 if not
+ */
+int saveCheckpointEntry(std::string path, const checkpointEntry& entry);
+
+#endif
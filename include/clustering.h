@@ -0,0 +1,70 @@
+#ifndef CLUSTERING_H
+#define CLUSTERING_H
+
+#include "includes.h"
+
+#define NO_CLUSTER 0 // Cluster id of ground points and points without return
+
+enum ClusterMethod { CLUSTER_NONE, CLUSTER_SLR, CLUSTER_VOXEL };
+
+struct clusterParams {
+	ClusterMethod method;
+	int numColumns;      // Num. of azimuth columns of the ring grid (n = ring * numColumns + column)
+	float runThresh;     // Max. distance between consecutive points of a run
+	float mergeThresh;   // Max. distance between points of runs merged across rings
+	float tolerance;     // Max. distance between neighbouring points of a Euclidean cluster
+};
+
+/*
+ *	Parses the name of a clustering method (none, slr or voxel).
+ *
+ *  @params
+ *  	method name (string)
+ * 		reference to method (ClusterMethod)
+ *  @return 1 if successful, 0 if not
+ */
+int parseClusterMethod(std::string name, ClusterMethod& method);
+
+/*
+ *	Scan Line Run clustering of the non-ground points (Zermas et al.). Every ring of 
+ *  the ring grid is split into runs of consecutive points closer than runThresh, 
+ *  and the runs are merged with the runs of the previous ring that have a point 
+ *  closer than mergeThresh in the neighbouring columns. Label equivalences are 
+ *  resolved with union-find, so the whole pass is linear in the number of points.
+ *
+ *  @params
+ * 		reference to labeled pointcloud (vector<point_XYZIRL>)
+ *      clustering parameters (clusterParams)
+ *      reference to cluster ids, one per point, NO_CLUSTER for ground (vector<int>)
+ *  @return number of clusters (int)
+ */
+int clusterScanLineRuns(const std::vector<point_XYZIRL>& pointCloud, const clusterParams& params, std::vector<int>& clusterIds);
+
+/*
+ *	Euclidean clustering of the non-ground points, for clouds without ring information
+ *  (e.g. upsampled or merged data). Points are hashed into voxels of the tolerance
+ *  size in a flat open-addressing table, so the candidate neighbours of a point are
+ *  the points of the 27 surrounding voxels, found in O(1) without building a k-d 
+ *  tree. Voxels are processed in parallel and connected components are built with
+ *  a lock-free union-find.
+ *
+ *  @params
+ * 		reference to labeled pointcloud (vector<point_XYZIRL>)
+ *      clustering parameters (clusterParams)
+ *      reference to cluster ids, one per point, NO_CLUSTER for ground (vector<int>)
+ *  @return number of clusters (int)
+ */
+int clusterVoxelHash(const std::vector<point_XYZIRL>& pointCloud, const clusterParams& params, std::vector<int>& clusterIds);
+
+/*
+ *	Runs the selected clustering method on the non-ground points.
+ *
+ *  @params
+ * 		reference to labeled pointcloud (vector<point_XYZIRL>)
+ *      clustering parameters (clusterParams)
+ *      reference to cluster ids, empty if no method is selected (vector<int>)
+ *  @return number of clusters (int)
+ */
+int clusterPoints(const std::vector<point_XYZIRL>& pointCloud, const clusterParams& params, std::vector<int>& clusterIds);
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef DAEMONCLIENT_H
+#define DAEMONCLIENT_H
+
+#include "segmentDaemon.h"
+
+/*
+ *	Client of the segmentation daemon (see segmentDaemon.h). Frames are copied into the
+ *  next free slot of a shared-memory ring and labeled by the daemon in place, so up to
+ *  numSlots frames can be in flight before waiting for the first labels.
+ *
+ *  A client is not thread safe; use one per thread.
+ */
+class DaemonClient {
+public:
+	DaemonClient();
+	~DaemonClient();
+
+	/*
+	 *	Creates the ring and connects to the daemon.
+	 *
+	 *  @params
+	 *  	socket path of the daemon (string)
+	 * 		num. of slots of the ring, max. frames in flight (int)
+	 * 		max. points per frame (int)
+	 *  @return 1 if successful, 0 if not
+	 */
+	int connect(std::string socketPath, int numSlots, int maxPoints);
+
+	/*
+	 *	Submits a frame to the next free slot.
+	 *
+	 *  @params
+	 *  	point cloud (vector<point_XYZIRL>)
+	 *  @return 1 if successful, 0 if the ring is full, the frame too large or the daemon gone
+	 */
+	int submit(const std::vector<point_XYZIRL>& pointCloud);
+
+	/*
+	 *	Waits for the labels of the oldest frame submitted.
+	 *
+	 *  @params
+	 *  	reference to the label of every point (vector<unsigned char>)
+	 * 		reference to milliseconds spent labeling in the daemon, NULL if not needed (float*)
+	 *  @return number of ground points found, -1 if nothing is pending or on error (int)
+	 */
+	int wait(std::vector<unsigned char>& labels, float* time = NULL);
+
+	/*
+	 *	Submits a frame and waits for its labels, with nothing else in flight.
+	 *
+	 *  @params
+	 *  	point cloud (vector<point_XYZIRL>)
+	 * 		reference to the label of every point (vector<unsigned char>)
+	 *  @return number of ground points found, -1 on error (int)
+	 */
+	int segment(const std::vector<point_XYZIRL>& pointCloud, std::vector<unsigned char>& labels);
+
+	// Frames submitted and not waited for yet
+	int getNumPending() const { return numPending; }
+
+	/*
+	 *	Disconnects and frees the ring.
+	 */
+	void close();
+
+private:
+	int sock;
+	void* ring;
+	size_t ringSize;
+	int numSlots;
+	int maxPoints;
+	int nextSlot;
+	int numPending;
+	std::vector<int> slotPoints;  // Points submitted in every slot
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef GROUNDEVALUATION_H
+#define GROUNDEVALUATION_H
+
+#include "includes.h"
+
+/*
+ *	Confusion counts of the ground labels of one or more frames against their
+ *  ground truth (points labeled GROUND_LABEL in the input).
+ */
+struct groundScore {
+	long truePositives;   // Ground points labeled as ground
+	long falsePositives;  // Non-ground points labeled as ground
+	long falseNegatives;  // Ground points not labeled as ground
+	long numPoints;       // Num. of points evaluated
+};
+
+/*
+ *	Moves the input labels of a point cloud into a ground truth mask indexed by the
+ *  input position of the points (idx), and clears the labels so the input does not
+ *  leak into the labeling.
+ *
+ *  @params
+ *  	reference to pointcloud (vector<point_XYZIRL>)
+ * 		reference to ground truth, 1 for ground points (vector<unsigned char>)
+ *  @return number of ground truth points (int)
+ */
+int extractGroundTruth(std::vector<point_XYZIRL>& pointCloud, std::vector<unsigned char>& truth);
+
+/*
+ *	Adds the confusion counts of a labeled point cloud to a score. Points missing
+ *  from the labeled cloud count as not labeled as ground.
+ *
+ *  @params
+ *  	labeled pointcloud (vector<point_XYZIRL>)
+ * 		ground truth from extractGroundTruth (vector<unsigned char>)
+ *      reference to score (groundScore)
+ *  @return void
+ */
+void scoreGroundLabels(const std::vector<point_XYZIRL>& labeledPointCloud, const std::vector<unsigned char>& truth, groundScore& score);
+
+/*
+ *	Gets the precision (TP / (TP + FP)) and recall (TP / (TP + FN)) of a score,
+ *  1 if undefined.
+ *
+ *  @params
+ *  	score (groundScore)
+ *  @return precision or recall (double)
+ */
+double getPrecision(const groundScore& score);
+double getRecall(const groundScore& score);
+
+#endif
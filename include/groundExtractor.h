@@ -2,6 +2,8 @@
 #define GROUNDEXTRACTOR_H
 
 #include "includes.h"
+#include "pointCloud.h"
+#include <chrono>
 
 /* 
  *	Computes the initial seeds used to estimate the ground plane. It first computes 
@@ -19,6 +21,23 @@
  */
 void extractInitialSeedPoints(const std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZIRL>& seedPoints, int numLPR, float seedThresh, bool method);
 
+/* 
+ *	Same as extractInitialSeedPoints on a range of points sorted on the z-axis. The 
+ *  median LPR is computed in the given scratch buffer, so nothing is allocated once
+ *  the buffers are large enough.
+ *
+ *  @params 
+ *  	first point (const point_XYZIRL*)
+ * 		number of points (int)
+ * 		reference to the seeds, appended to (vector<point_XYZIRL>)
+ *      number of points needed to estimate LPR (int)
+ *      seed threshold for LPR (float)
+ *      method to use: means / medians (bool)
+ *      reference to scratch buffer (vector<float>)
+ *  @return void
+ */
+void extractInitialSeedPoints(const point_XYZIRL* points, int numPoints, std::vector<point_XYZIRL>& seedPoints, int numLPR, float seedThresh, bool method, std::vector<float>& scratch);
+
 /* 
  *	Computes the median value of each coordinate axis of the seeds. The resulting
  *	values are considered to be good representatives of the plane values. Also, using
@@ -65,5 +84,107 @@ Eigen::MatrixXf estimatePlaneNormal(const std::vector<point_XYZIRL>& seeds, cons
  */
 float getDistance(Eigen::MatrixXf vec3x1, Eigen::MatrixXf vec1x3);
 
+/* 
+ *	Ground plane of a segment: n.T * X + d = 0
+ */
+struct planeModel {
+	Eigen::Vector3f normal;  // Normal of the plane (n), pointing up
+	float negDist;           // Offset of the plane (d = -(n.T * X))
+	int numSeeds;            // Num. of seeds used in the last estimation
+	float residual;          // RMS distance of the ground points to the plane
+	bool valid;              // A plane was estimated
+};
+
+/* 
+ *	Where the plane of a segment comes from, or why it has none
+ */
+enum PlaneStatus {
+	PLANE_FITTED,     // Estimated from the seeds of the segment
+	PLANE_INHERITED,  // Averaged from the planes of its neighbours (polar bins)
+	PLANE_NO_SEEDS,   // No seeds were extracted, so no plane was estimated
+	PLANE_SPARSE      // Too few points to estimate a plane and none inherited (polar bins)
+};
+
+/* 
+ *	Plane and fit statistics of a segment, as saved to the planes sidecar
+ */
+struct segmentStats {
+	int id;                  // Index of the segment (x-axis chunk, polar bin or sector)
+	planeModel plane;        // Estimated or inherited plane
+	PlaneStatus status;      // Where the plane comes from, or why it is not valid
+	int numPoints;           // Num. of points of the segment, mirror reflections included
+	int numGround;           // Num. of points labeled as ground
+	double time;             // Time spent on the segment (ms)
+};
+
+/* 
+ *	Estimates the ground plane of a segment iteratively from the given initial seeds
+ *  and labels the points close enough to the last estimated plane as ground. The
+ *  signed distance of every point to that plane is kept as its height (h). Points are
+ *  compared to the normal with the sign SVD gives it, as they always were, except on
+ *  the polar grid, where it points up like the planes bins inherit.
+ *
+ *  @params   
+ * 		reference to segment sorted on the z-axis (vector<point_XYZIRL>)
+ * 		reference to the initial seeds, consumed by the estimation (vector<point_XYZIRL>)
+ *      algorithm parameters (groundParams)
+ *      reference to the estimated plane (planeModel)
+ *  @return number of ground points found (int)
+ */
+int fitGroundSegment(std::vector<point_XYZIRL>& segment, std::vector<point_XYZIRL>& seeds, const groundParams& params, planeModel& plane);
+
+/* 
+ *	Same as fitGroundSegment on a range of points. Works on fixed-size matrices and
+ *  computes the medians in the given scratch buffer, so nothing is allocated once the
+ *  buffers are large enough.
+ *
+ *  @params   
+ * 		first point of the segment (point_XYZIRL*)
+ * 		number of points (int)
+ * 		reference to the initial seeds, consumed by the estimation (vector<point_XYZIRL>)
+ *      reference to scratch buffer (vector<float>)
+ *      algorithm parameters (groundParams)
+ *      reference to the estimated plane (planeModel)
+ *  @return number of ground points found (int)
+ */
+int fitGroundSegment(point_XYZIRL* segment, int numPoints, std::vector<point_XYZIRL>& seeds, std::vector<float>& scratch, const groundParams& params, planeModel& plane);
+
+/* 
+ *	Runs the GLA on a whole point cloud. The cloud is sorted on the x-axis and split
+ *  into equal-count segments; a ground plane is estimated for each segment and the 
+ *  points close enough to it are labeled as ground. Points filtered as mirror 
+ *  reflections are kept unlabeled. When params.polarGrid is set the segments are the
+ *  bins of the polar grid instead. The labeled cloud is in input order. Runs a new
+ *  GroundSegmenter, which should be kept instead when many clouds are labeled.
+ *
+ *  @params   
+ * 		reference to pointcloud (vector<point_XYZIRL>)
+ * 		reference to labeled pointcloud (vector<point_XYZIRL>)
+ *      algorithm parameters (groundParams)
+ *  @return number of ground points found (int)
+ */
+int labelGroundPoints(std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZIRL>& labeledPointCloud, const groundParams& params);
+
+/* 
+ *	Same as labelGroundPoints, also returning the plane and fit statistics of every 
+ *  segment with points.
+ *
+ *  @params   
+ * 		reference to pointcloud (vector<point_XYZIRL>)
+ * 		reference to labeled pointcloud (vector<point_XYZIRL>)
+ *      algorithm parameters (groundParams)
+ *      reference to the statistics of the segments (vector<segmentStats>)
+ *  @return number of ground points found (int)
+ */
+int labelGroundPoints(std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZIRL>& labeledPointCloud, const groundParams& params, std::vector<segmentStats>& stats);
+
+/* 
+ *	Gets the name of a plane status as saved to the planes sidecar.
+ *
+ *  @params   
+ * 		status (PlaneStatus)
+ *  @return name (const char*)
+ */
+const char* getPlaneStatusName(PlaneStatus status);
 
 #endif
@@ -0,0 +1,120 @@
+#ifndef GROUNDSEGMENTER_H
+#define GROUNDSEGMENTER_H
+
+#include "groundExtractor.h"
+
+/*
+ *	Runs the GLA on whole point clouds and returns their labels in input order. The
+ *  segments are equal-count chunks of the cloud sorted on the x-axis or, when
+ *  params.polarGrid is set, the bins of the polar grid (see polarGrid.h), which are
+ *  estimated in parallel and where sparse bins inherit the plane of their neighbours.
+ *  Mirror reflections and points out of the grid are kept unlabeled, and points
+ *  without return (all-zero padding) are skipped unless disabled.
+ *
+ *  The segmenter owns its configuration and every buffer of the pipeline, which are
+ *  reused from frame to frame: once they have grown to the largest frame, segmenting
+ *  does not allocate. With temporal state enabled, the seeds of every segment are the
+ *  points close to the plane the same segment had in the previous frame, and the LPR
+ *  seeds are used when there is no such plane or it does not fit anymore.
+ *
+ *  A segmenter is not thread safe; use one per thread.
+ */
+class GroundSegmenter {
+public:
+	/*
+	 *	@params
+	 *		algorithm parameters (groundParams)
+	 */
+	GroundSegmenter(const groundParams& params);
+
+	/*
+	 *	Labels the ground points of a point cloud.
+	 *
+	 *  @params
+	 *  	point cloud (vector<point_XYZIRL>)
+	 * 		reference to the label of every point, in input order (vector<unsigned char>)
+	 *  @return number of ground points found (int)
+	 */
+	int segment(const std::vector<point_XYZIRL>& pointCloud, std::vector<unsigned char>& labels);
+
+	/*
+	 *	Same as segment, returning the labeled points in input order, with their height
+	 *  above the plane. Skipped points without return are returned as zero points.
+	 *
+	 *  @params
+	 *  	point cloud (vector<point_XYZIRL>)
+	 * 		reference to labeled pointcloud (vector<point_XYZIRL>)
+	 *  @return number of ground points found (int)
+	 */
+	int segment(const std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZIRL>& labeledPointCloud);
+
+	/*
+	 *	Same as segment, copying the coordinates from the caller's buffers once and
+	 *  writing the label and height of every point into caller-owned arrays. The same
+	 *  stride works for separate coordinate arrays (sizeof(float)) and for interleaved
+	 *  points (size of a point).
+	 *
+	 *  @params
+	 *  	x, y and z of the first point (const float*)
+	 * 		bytes between two consecutive points (int)
+	 * 		num. of points (int)
+	 * 		reference to the label of every point (unsigned char*)
+	 * 		reference to the height of every point, NULL if not needed (float*)
+	 *  @return number of ground points found (int)
+	 */
+	int segment(const float* x, const float* y, const float* z, int stride, int numPoints, unsigned char* labels, float* heights);
+
+	// Height of every point of the last frame above its plane, in input order (NAN if unknown)
+	const std::vector<float>& getHeights() const { return heights; }
+
+	// Plane and fit statistics of every segment with points of the last frame
+	const std::vector<segmentStats>& getStats() const { return stats; }
+
+	const groundParams& getParams() const { return params; }
+
+	// Skip points without return (default), or segment them as any other point
+	void setSkipZero(bool skip) { skipZero = skip; }
+
+	// Warm-start the seeds from the planes of the previous frame (off by default)
+	void setTemporal(bool enabled);
+
+	// Forgets the planes of the previous frame
+	void reset();
+
+private:
+	// Buffers of the estimation of one segment, one set per thread
+	struct fitScratch {
+		std::vector<point_XYZIRL> seeds;
+		std::vector<float> values;
+	};
+
+	groundParams params;
+	bool skipZero;
+	bool temporal;
+	std::vector<point_XYZIRL> points;     // Points being segmented, idx is their input position
+	std::vector<int> emptyPositions;      // Input position of the skipped points
+	std::vector<float> heights;
+	std::vector<segmentStats> stats;
+	std::vector<planeModel> priorPlanes;  // Plane of every segment in the previous frame
+	std::vector<fitScratch> threadScratch;
+
+	// Polar grid
+	std::vector<int> bins;
+	std::vector<int> binStart;
+	std::vector<int> binEnd;
+	std::vector<point_XYZIRL> binned;
+	std::vector<planeModel> planes;
+	std::vector<planeModel> inherited;
+	std::vector<char> fitted;
+	std::vector<int> binGround;
+	std::vector<double> binTime;
+
+	int labelFrame(const std::vector<point_XYZIRL>& pointCloud);
+	int labelPoints();
+	int labelSegments();
+	int labelPolar();
+	void getSeeds(const point_XYZIRL* segment, int numPoints, int segmentId, fitScratch& scratch) const;
+	void keepPlanes();
+};
+
+#endif
@@ -0,0 +1,115 @@
+#ifndef GROUNDSEG_H
+#define GROUNDSEG_H
+
+/*
+ *	C interface of the ground segmenter (libgroundseg.so), for programs and plugins
+ *  that cannot use the C++ classes. Only the functions and structs of this header are
+ *  exported; their layout and behaviour only change with GROUNDSEG_ABI_VERSION.
+ *
+ *  A handle owns a GroundSegmenter (see groundSegmenter.h) with all its buffers, so
+ *  segmenting frames of the same size through one handle does not allocate after the
+ *  first frame. The points are copied once from the caller's buffers into scratch owned
+ *  by the handle, and the labels are written into a caller-owned array.
+ *
+ *  Thread safety: a handle must not be used from two threads at the same time, but
+ *  different handles can be used concurrently, e.g. one per sensor or per thread. On
+ *  the polar grid a handle estimates its bins on an OpenMP team of its own.
+ */
+
+#include <stddef.h>
+
+#define GROUNDSEG_ABI_VERSION 1
+#define GROUNDSEG_GROUND_LABEL 4  // Label of the ground points, 0 for the rest
+
+#if defined(__GNUC__)
+#define GROUNDSEG_API __attribute__((visibility("default")))
+#else
+#define GROUNDSEG_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct gsSegmenter gsSegmenter;  // Opaque handle
+
+typedef struct {
+	int numLPR;        // Num. of points used to estimate the LPR
+	int numSegments;   // Num. of segments along the x-axis
+	int numIters;      // Num. of plane estimations per segment
+	float seedThresh;  // Max. value to determine a seed
+	float distThresh;  // Max. value to determine ground distance
+	int method;        // Use means (1) or medians (0) to extract seeds
+	int polarGrid;     // Segment on a polar grid instead of along the x-axis
+	int skipZero;      // Skip points at the origin (no return)
+	int temporal;      // Warm-start the seeds from the planes of the previous frame
+} gsParams;
+
+/*
+ *	Gets the ABI version the library was built with, to check it against the header.
+ *
+ *  @return GROUNDSEG_ABI_VERSION of the library (int)
+ */
+GROUNDSEG_API int gsGetAbiVersion(void);
+
+/*
+ *	Fills the parameters with the defaults of extractGround.
+ *
+ *  @params
+ *  	reference to parameters (gsParams*)
+ *  @return void
+ */
+GROUNDSEG_API void gsGetDefaultParams(gsParams* params);
+
+/*
+ *	Creates a segmenter.
+ *
+ *  @params
+ *  	parameters, copied (const gsParams*)
+ *  @return handle, NULL if the parameters are not valid or out of memory (gsSegmenter*)
+ */
+GROUNDSEG_API gsSegmenter* gsCreate(const gsParams* params);
+
+/*
+ *	Destroys a segmenter and frees its buffers. NULL is ignored.
+ *
+ *  @params
+ *  	handle (gsSegmenter*)
+ *  @return void
+ */
+GROUNDSEG_API void gsDestroy(gsSegmenter* segmenter);
+
+/*
+ *	Labels the ground points of a frame. The coordinates are read with a stride in bytes,
+ *  the same for x, y and z: sizeof(float) for separate arrays, or the size of a point
+ *  for interleaved points, e.g. x, y and z pointing into the first point of a
+ *  PointCloud2 buffer with its point_step as stride. Coordinates are copied byte by
+ *  byte, so packed points with any stride can be read.
+ *
+ *  @params
+ *  	handle (gsSegmenter*)
+ * 		x, y and z of the first point (const float*)
+ * 		bytes between two consecutive points (size_t)
+ * 		num. of points (size_t)
+ * 		array of numPoints labels to fill, GROUNDSEG_GROUND_LABEL or 0 (unsigned char*)
+ * 		array of numPoints heights above the ground plane to fill (NAN if unknown),
+ * 		NULL if not needed (float*)
+ *  @return number of ground points found, -1 on error (long)
+ */
+GROUNDSEG_API long gsSegment(gsSegmenter* segmenter, const float* x, const float* y, const float* z, size_t stride,
+                             size_t numPoints, unsigned char* labels, float* heights);
+
+/*
+ *	Forgets the planes of the previous frame, e.g. after a jump in the input.
+ *
+ *  @params
+ *  	handle (gsSegmenter*)
+ *  @return void
+ */
+GROUNDSEG_API void gsReset(gsSegmenter* segmenter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
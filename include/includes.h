@@ -13,5 +13,8 @@
 #define THRESH_ERROR  -3.2
 #define GROUND_LABEL 4
 #define PI 3.14159265
+#define HEIGHT_SCALE 1000.0   // Quantized heights are in millimeters
+#define NO_HEIGHT_I16 -32768  // Quantized height of points without ground plane
+#define MAX_LABEL_RUN 65535   // Max. length of a run of the RLE label files
 
 #endif
@@ -0,0 +1,148 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include "includes.h"
+
+#define FNV_OFFSET 14695981039346656037ULL  // Initial value of an FNV-1a 64 hash
+
+/*
+ *	Manifest-driven batch runs. A manifest lists one input file per line (empty lines
+ *  and lines starting with # are skipped); relative paths are relative to the manifest.
+ *  Every entry belongs to the shard given by a stable hash of the entry as written, so
+ *  any machine with the same manifest and number of shards picks the same files with
+ *  no coordinator. Every shard writes a manifest of its outputs, a tab-separated file
+ *  with a line per input, which merging validates against the input manifest.
+ */
+
+struct manifestEntry {
+	std::string input;   // Entry of the input manifest
+	std::string output;  // Output file, relative to the output directory
+	long numPoints;
+	long numGround;
+	double time;         // Milliseconds spent on the file
+};
+
+struct mergeSummary {
+	long numInputs;      // Entries of the input manifest
+	long numDone;        // Inputs with an output in the right shard
+	long numMissing;     // Inputs without output
+	long numDuplicated;  // Inputs listed more than once by the shards
+	long numUnknown;     // Outputs of inputs not in the manifest
+	long numMisplaced;   // Outputs in the manifest of another shard
+	long numNoFile;      // Outputs listed but not found in the output directory
+	long numPoints;
+	long numGround;
+	double time;
+};
+
+/*
+ *	Reads the entries of an input manifest, in order.
+ *
+ *  @params
+ *  	manifest path (string)
+ * 		reference to entries (vector<string>)
+ *  @return 1 if successful, 0 if it can not be read or an entry is not valid (a tab,
+ *  a .. component, repeated or with the same output as another entry)
+ */
+int readManifest(std::string path, std::vector<std::string>& entries);
+
+/*
+ *	Gets the path of an entry of a manifest.
+ *
+ *  @params
+ *  	manifest path (string)
+ * 		entry (string)
+ *  @return entry if absolute, else relative to the directory of the manifest (string)
+ */
+std::string getManifestInput(std::string manifestPath, std::string entry);
+
+/*
+ *	Gets the output of an entry, relative to the output directory: the entry itself,
+ *  without its leading / and its empty and . components, so inputs with the same name
+ *  in different directories do not collide. Entries naming the same file this way,
+ *  e.g. /a/x.txt, a/x.txt and ./a/x.txt, are rejected by readManifest.
+ *
+ *  @params
+ *  	entry (string)
+ *  @return output path (string)
+ */
+std::string getManifestOutput(std::string entry);
+
+/*
+ *	Parses a shard given as i/N, 0 <= i < N.
+ *
+ *  @params
+ *  	shard (string)
+ * 		reference to shard index (int)
+ * 		reference to num. of shards (int)
+ *  @return 1 if valid, 0 if not
+ */
+int parseShard(std::string spec, int& shard, int& numShards);
+
+/*
+ *	Hashes bytes with FNV-1a 64, continuing a previous hash.
+ *
+ *  @params
+ *  	bytes (const void*)
+ * 		num. of bytes (size_t)
+ * 		hash so far, FNV_OFFSET to start (unsigned long long)
+ *  @return hash (unsigned long long)
+ */
+unsigned long long getFnvHash(const void* data, size_t size, unsigned long long hash);
+
+/*
+ *	Gets the shard of an entry: FNV-1a hash of the entry modulo the num. of shards.
+ *
+ *  @params
+ *  	entry (string)
+ * 		num. of shards (int)
+ *  @return shard (int)
+ */
+int getShard(const std::string& entry, int numShards);
+
+/*
+ *	Gets the path of the output manifest of a shard, shard_<i>_of_<N>.tsv.
+ *
+ *  @params
+ *  	output directory (string)
+ * 		shard index (int)
+ * 		num. of shards (int)
+ *  @return path (string)
+ */
+std::string getShardManifestPath(std::string outDir, int shard, int numShards);
+
+/*
+ *	Appends an entry to an output manifest, writing the header first if it is empty.
+ *  The line is flushed so a run that dies keeps the entries of the files it finished.
+ *
+ *  @params
+ *  	output manifest path (string)
+ * 		entry (manifestEntry)
+ *  @return 1 if successful, 0 if not
+ */
+int saveManifestEntry(std::string path, const manifestEntry& entry);
+
+/*
+ *	Reads an output manifest. A last line cut short by a dying run is ignored.
+ *
+ *  @params
+ *  	output manifest path (string)
+ * 		reference to entries (vector<manifestEntry>)
+ *  @return 1 if successful, 0 if it can not be read
+ */
+int readShardManifest(std::string path, std::vector<manifestEntry>& entries);
+
+/*
+ *	Validates the output manifests of every shard in an output directory against the
+ *  input manifest, and saves the outputs of the inputs in manifest order to
+ *  manifest.tsv in the same directory.
+ *
+ *  @params
+ *  	input manifest path (string)
+ * 		output directory (string)
+ * 		reference to summary (mergeSummary)
+ *  @return 1 if every input is done exactly once, 0 if not or on error
+ */
+int mergeShardManifests(std::string manifestPath, std::string outDir, mergeSummary& summary);
+
+#endif
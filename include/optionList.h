@@ -0,0 +1,20 @@
+#ifndef OPTIONLIST_H
+#define OPTIONLIST_H
+
+#include <string>
+#include <vector>
+
+/*
+ *	Parses a comma separated list of values given as a command line option, e.g.
+ *  --seg 1,2,4 or --thdist 0.2,0.3. Spaces around the values and empty values are
+ *  skipped.
+ *
+ *  @params
+ *  	values (string)
+ * 		reference to the parsed values (vector<int> or vector<float>)
+ *  @return 1 if every value is a number and there is at least one, 0 if not
+ */
+int parseList(std::string values, std::vector<int>& list);
+int parseList(std::string values, std::vector<float>& list);
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef PCAPREADER_H
+#define PCAPREADER_H
+
+#include <stdio.h>
+#include "includes.h"
+
+#define VELODYNE_DATA_PORT 2368
+
+/*
+ *	Minimal reader of libpcap capture files. It walks the records of the capture and
+ *  returns the payload of the UDP datagrams sent to a given port, so Velodyne packets
+ *  can be decoded without ROS or libpcap installed. Ethernet (with or without VLAN
+ *  tags) and Linux cooked captures of IPv4 traffic are supported.
+ */
+class PcapReader {
+public:
+	PcapReader();
+	~PcapReader();
+
+	/*
+	 *	Opens a capture file and validates its global header.
+	 *
+	 *  @params
+	 *  	path to the pcap file (string)
+	 * 		UDP destination port to keep, 0 keeps every datagram (int)
+	 *  @return 1 if successful, 0 if not
+	 */
+	int open(std::string pathToFile, int port);
+
+	/*
+	 *	Reads the next UDP payload sent to the selected port. The payload points to an
+	 *  internal buffer that is valid until the next call.
+	 *
+	 *  @params
+	 *  	reference to payload pointer (const unsigned char*)
+	 * 		reference to payload size (size_t)
+	 *      reference to capture timestamp in seconds (double)
+	 *  @return 1 if a packet was read, 0 at the end of the capture
+	 */
+	int nextPacket(const unsigned char*& payload, size_t& size, double& timestamp);
+
+	/*
+	 *	Closes the capture file.
+	 */
+	void close();
+
+private:
+	FILE* file;
+	bool swapped;   // Capture written with the opposite byte order
+	bool nanosec;   // Timestamps have nanosecond resolution
+	int linkType;
+	int port;
+	std::vector<unsigned char> record;
+	std::vector<char> fileBuffer;
+
+	unsigned int toHost(unsigned int value) const;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <string>
+
+/*
+ *	Hardware counters read with perf_event_open around the stages of the pipeline.
+ *  Only user space is counted, which perf_event_paranoid <= 2 allows. Counters the
+ *  kernel or the CPU do not provide (containers, VMs without PMU) read as -1.
+ */
+enum PerfCounter {
+	COUNTER_CYCLES,
+	COUNTER_INSTRUCTIONS,
+	COUNTER_CACHE_MISSES,   // Last level cache misses
+	COUNTER_BRANCH_MISSES,
+	NUM_COUNTERS
+};
+
+/*
+ *	Enables the counters. They are opened on every thread the first time it reads
+ *  them, and stay open until the thread exits.
+ *
+ *  @params
+ *  	enable (bool)
+ *  @return void
+ */
+void enablePerfCounters(bool enabled);
+
+/*
+ *	Checks if the counters are enabled.
+ *
+ *  @return true if enabled
+ */
+bool isCounting();
+
+/*
+ *	Gets the name of a counter as used in the run report.
+ *
+ *  @params
+ *  	counter (PerfCounter)
+ *  @return name (const char*)
+ */
+const char* getCounterName(PerfCounter counter);
+
+/*
+ *	Reads the counters of the calling thread since they were opened, scaled up when
+ *  the kernel multiplexes them. Counters the kernel has not scheduled yet are not
+ *  available.
+ *
+ *  @params
+ *  	values, -1 for the counters not available (long long[NUM_COUNTERS])
+ *  @return 1 if any counter could be read, 0 if not
+ */
+int readPerfCounters(long long values[NUM_COUNTERS]);
+
+/*
+ *	Gets why the counters are not available, e.g. the error of perf_event_open.
+ *
+ *  @return empty if every counter could be opened (string)
+ */
+std::string getPerfCountersError();
+
+#endif
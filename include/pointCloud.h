@@ -35,6 +35,93 @@ void printPointCloud(const std::vector<point_XYZIRL>& pointCloud, int num);
  */
 void sortPointCloud(std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZIRL>& filtered, bool filter, std::string axis);
 
+/* 
+ *	Drops the points without return (the all-zero cells of the SqueezeSeg grid) from
+ *  a point cloud, so they do not go through sorting, seed extraction and labeling 
+ *  or skew the LPR. They keep their grid and input indices to restore the original
+ *  layout.
+ *  
+ *  @params 
+ * 		reference to pointcloud (vector<point_XYZIRL>)
+ *      reference to dropped points (vector<point_XYZIRL>)
+ *  @return number of dropped points (int)
+ */
+int compactPointCloud(std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZIRL>& emptyPoints);
+
+/* 
+ *	Adds back the points dropped by compactPointCloud as unlabeled zero points with
+ *  their grid and input indices, so orderPointCloud restores the original layout.
+ *  
+ *  @params 
+ * 		reference to pointcloud (vector<point_XYZIRL>)
+ *      dropped points (vector<point_XYZIRL>)
+ *  @return void
+ */
+void restorePointCloud(std::vector<point_XYZIRL>& pointCloud, const std::vector<point_XYZIRL>& emptyPoints);
+
+/* 
+ *	Puts every point back in the order of the input (idx) in linear time, undoing 
+ *  the sorting and regrouping done by the segmentation. Input positions without a
+ *  point, e.g. of segments without seeds, are skipped.
+ *  
+ *  @params 
+ * 		reference to pointcloud (vector<point_XYZIRL>)
+ *  @return 1 if successful, 0 if an input index is negative or repeated
+ */
+int orderPointCloud(std::vector<point_XYZIRL>& pointCloud);
+
+/* 
+ *	Converts a float to IEEE 754 half precision, rounding to nearest even.
+ *  
+ *  @params 
+ * 		value (float)
+ *  @return half precision bits (unsigned short)
+ */
+unsigned short floatToHalf(float value);
+
+/* 
+ *	Converts IEEE 754 half precision to float.
+ *  
+ *  @params 
+ * 		half precision bits (unsigned short)
+ *  @return value (float)
+ */
+float halfToFloat(unsigned short half);
+
+/* 
+ *	Quantizes a height above ground to millimeters, NO_HEIGHT_I16 if unknown.
+ *  
+ *  @params 
+ * 		height in meters (float)
+ *  @return quantized height (short)
+ */
+short quantizeHeight(float height);
+
+/* 
+ *	Saves only the labels of a point cloud, one byte (uint8) per point in the order
+ *  of the point cloud. With run-length encoding every run of equal labels is saved 
+ *  as a label byte followed by the run length (uint16, little endian), runs longer
+ *  than MAX_LABEL_RUN are split.
+ *  
+ *  @params 
+ * 		point cloud (vector<point_XYZIRL>)
+ *      file path (string)
+ *      run-length encode the labels (bool)
+ *  @return 1 if successful, 0 if not
+ */
+int saveLabels(const std::vector<point_XYZIRL>& pointCloud, std::string pathToFile, bool rle);
+
+/* 
+ *	Reads a label file saved by saveLabels.
+ *  
+ *  @params 
+ *      file path (string)
+ *      the labels are run-length encoded (bool)
+ * 		reference to the labels (vector<unsigned char>)
+ *  @return 1 if successful, 0 if not
+ */
+int getLabels(std::string pathToFile, bool rle, std::vector<unsigned char>& labels);
+
 /* 
  *	Convers LIDAR points from vector to MatrixXf
  *  
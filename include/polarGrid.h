@@ -0,0 +1,50 @@
+#ifndef POLARGRID_H
+#define POLARGRID_H
+
+#include "groundExtractor.h"
+
+#define POLAR_ZONES          4
+#define POLAR_MIN_BIN_POINTS 10 // Bins with fewer points inherit the plane of their neighbours
+
+/*
+ *	Concentric zone polar grid. The ground around the sensor is split into zones of 
+ *  increasing range, each one divided into rings (range bins) and sectors (azimuth 
+ *  bins); far zones use coarser bins since they get fewer points.
+ *
+ *     zone      range (m)     rings   sectors
+ *      0       2.7 - 12.3       2       16
+ *      1      12.3 - 22.6       4       32
+ *      2      22.6 - 41.1       4       54
+ *      3      41.1 - 80.0       4       32
+ */
+
+/*
+ *	Gets the number of bins of the polar grid.
+ *
+ *  @return number of bins (int)
+ */
+int getNumPolarBins();
+
+/*
+ *	Gets the polar bin of a point from its horizontal range and azimuth.
+ *
+ *  @params
+ *  	point (point_XYZIRL)
+ *  @return index of the bin, -1 if the point is out of the grid
+ */
+int getPolarBin(const point_XYZIRL& point);
+
+/*
+ *	Gets the average plane of the valid neighbours of a bin: the bins to the left and
+ *  right in the same ring and the bins of the inner and outer rings, possibly in
+ *  another zone. Sparse bins, and bins where no plane could be estimated, inherit it.
+ *
+ *  @params
+ *  	index of the bin (int)
+ * 		planes of every bin (vector<planeModel>)
+ * 		reference to the inherited plane (planeModel)
+ *  @return 1 if a neighbour had a valid plane, 0 if not
+ */
+int inheritPolarPlane(int bin, const std::vector<planeModel>& planes, planeModel& plane);
+
+#endif
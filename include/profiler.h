@@ -0,0 +1,154 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <string>
+#include <chrono>
+#include "tracer.h"
+#include "perfCounters.h"
+#include "allocTracker.h"
+
+/*
+ *	Stages of the pipeline timed by the profiler. Stages run by several threads at
+ *  once (e.g. the bins of the polar grid) add up the time of every thread.
+ */
+enum PipelineStage {
+	STAGE_READ,     // Reading and decoding the input, dropping zero padding
+	STAGE_SORT,     // Sorting and binning the points
+	STAGE_SEED,     // Seed extraction
+	STAGE_FIT,      // Plane estimation, seed refinement included
+	STAGE_LABEL,    // Final ground classification
+	STAGE_REORDER,  // Back to input order
+	STAGE_CLUSTER,  // Clustering of the non-ground points
+	STAGE_WRITE,    // Writing the output
+	NUM_STAGES
+};
+
+/*
+ *	Enables the profiler and starts the wall clock of the run. While disabled the
+ *  stage scopes do not read the clock.
+ *
+ *  @params
+ *  	enable (bool)
+ *  @return void
+ */
+void enableProfiler(bool enabled);
+
+/*
+ *	Checks if the profiler is enabled.
+ *
+ *  @return true if enabled
+ */
+bool isProfiling();
+
+/*
+ *	Gets the name of a stage as used in the run report.
+ *
+ *  @params
+ *  	stage (PipelineStage)
+ *  @return name (const char*)
+ */
+const char* getStageName(PipelineStage stage);
+
+/*
+ *	Adds time to a stage of the current frame. Thread safe.
+ *
+ *  @params
+ *  	stage (PipelineStage)
+ * 		time (nanoseconds)
+ *  @return void
+ */
+void addStageTime(PipelineStage stage, long long nanoseconds);
+
+/*
+ *	Adds the hardware counters of a scope to the totals of a stage. Thread safe.
+ *
+ *  @params
+ *  	stage (PipelineStage)
+ * 		counts, -1 for the counters not available (long long[NUM_COUNTERS])
+ *  @return void
+ */
+void addStageCounters(PipelineStage stage, const long long counts[NUM_COUNTERS]);
+
+/*
+ *	Closes the current frame: its stage times become samples of the percentiles of
+ *  the run report and a new frame starts.
+ *
+ *  @params
+ *  	num. of points of the frame (long)
+ *  @return void
+ */
+void endProfiledFrame(long numPoints);
+
+/*
+ *	Saves the run report as JSON: num. of frames and points, wall time, points per
+ *  second and, for every stage, its total time and the p50/p90/p99/max time per frame,
+ *  its hardware counters if they are enabled and its allocations if they are tracked,
+ *  with the allocations and peak heap of every frame.
+ *
+ *  @params
+ *  	file path (string)
+ * 		JSON object with the configuration of the run, empty if none (string)
+ *  @return 1 if successful, 0 if not
+ */
+int saveRunReport(std::string pathToFile, std::string configuration);
+
+/*
+ *	Quotes a text as a JSON string, escaping quotes, backslashes and control
+ *  characters.
+ *
+ *  @params
+ *  	text (string)
+ *  @return JSON string, with its quotes (string)
+ */
+std::string getJsonString(const std::string& text);
+
+/*
+ *	Times the enclosing scope as a stage of the current frame, counting its cycles,
+ *  instructions and misses if the counters are enabled and attributing its
+ *  allocations to the stage if they are tracked, and records it as a trace event
+ *  when tracing.
+ *
+ *	    {
+ *	        StageScope scope(STAGE_SEED);
+ *	        extractInitialSeedPoints(...);
+ *	    }
+ */
+class StageScope {
+public:
+	StageScope(PipelineStage stage) : stage(stage), profiled(isProfiling()), traced(TRACE_ENABLED()) {
+		counted = profiled && isCounting() && readPerfCounters(counts);
+		scoped = profiled && ALLOC_TRACKED();
+		if (scoped) previousScope = setAllocationScope(stage);
+		if (profiled || traced) start = std::chrono::steady_clock::now();
+	}
+	~StageScope() {
+		stop();
+	}
+
+	// Ends the scope before leaving it
+	void stop() {
+		if (!profiled && !traced) return;
+		if (scoped) setAllocationScope(previousScope);
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+		if (profiled) addStageTime(stage, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+		long long endCounts[NUM_COUNTERS];
+		if (counted && readPerfCounters(endCounts)) {
+			for (int c = 0; c < NUM_COUNTERS; c++) counts[c] = counts[c] < 0 ? -1 : endCounts[c] - counts[c];
+			addStageCounters(stage, counts);
+		}
+		if (traced) addTraceEvent(getStageName(stage), -1, start, end);
+		profiled = traced = counted = scoped = false;
+	}
+
+private:
+	PipelineStage stage;
+	bool profiled;
+	bool traced;
+	bool counted;
+	bool scoped;
+	int previousScope;               // Allocation scope of the enclosing code
+	long long counts[NUM_COUNTERS];  // At the start of the scope
+	std::chrono::steady_clock::time_point start;
+};
+
+#endif
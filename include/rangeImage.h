@@ -0,0 +1,69 @@
+#ifndef RANGEIMAGE_H
+#define RANGEIMAGE_H
+
+#include "includes.h"
+
+#define EMPTY_CELL -1
+
+/*
+ *	Organized (ring x column) representation of a scan. Every cell holds a copy of
+ *  its point and the index of the point in the flat cloud it was built from, so the
+ *  neighbours of any point are found by index arithmetic and rings can be scanned 
+ *  with contiguous memory accesses. Empty cells have the index EMPTY_CELL. Points 
+ *  falling in an occupied cell are kept aside so no point is lost when converting 
+ *  back to a flat cloud. It is used by the Scan Line Run clustering only; ground
+ *  labeling still works on the flat cloud.
+ */
+class RangeImage {
+public:
+	/*
+	 *	@params
+	 *		num. of azimuth columns of the ring grid (int)
+	 */
+	RangeImage(int numColumns);
+
+	/*
+	 *	Fills the image in one pass from the ring grid index of every point, 
+	 *  n = ring * numColumns + column, as in the SqueezeSeg frames and the Velodyne decoder.
+	 *
+	 *  @params
+	 *  	reference to pointcloud (vector<point_XYZIRL>)
+	 *  @return void
+	 */
+	void build(const std::vector<point_XYZIRL>& pointCloud);
+
+	/*
+	 *	Converts the image back to a flat cloud in ring order, with the points of 
+	 *  shared cells at the end.
+	 *
+	 *  @params
+	 *  	reference to pointcloud (vector<point_XYZIRL>)
+	 *  @return void
+	 */
+	void toPointCloud(std::vector<point_XYZIRL>& pointCloud) const;
+
+	int getNumRings() const { return numRings; }
+	int getNumColumns() const { return numColumns; }
+
+	// Index in the source cloud of the point of a cell, EMPTY_CELL if empty
+	int getIndex(int ring, int column) const { return indices[ring * numColumns + column]; }
+
+	// Point of a cell, only valid if the cell is not empty
+	const point_XYZIRL& getPoint(int ring, int column) const { return cells[ring * numColumns + column]; }
+
+	// Column at an offset from another one, wrapping around the revolution
+	int wrapColumn(int column) const { return (column % numColumns + numColumns) % numColumns; }
+
+	// Points that fell in an already occupied cell or out of the grid (source indices)
+	const std::vector<int>& getOverflow() const { return overflow; }
+
+private:
+	int numRings;
+	int numColumns;
+	std::vector<point_XYZIRL> cells;
+	std::vector<int> indices;
+	std::vector<int> overflow;
+	std::vector<point_XYZIRL> overflowPoints;
+};
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef SCENEGENERATOR_H
+#define SCENEGENERATOR_H
+
+#include <random>
+#include "velodyneDecoder.h"
+
+#define OBSTACLE_LABEL 1 // Label of the points of obstacles (car in the SqueezeSeg frames)
+
+struct sceneParams {
+	float sensorHeight;  // Height of the sensor above the ground under it (m)
+	float slopeX;        // Slope of the ground along x (dz/dx)
+	float slopeY;        // Slope of the ground along y (dz/dy)
+	float breakDist;     // x where the slope along x changes, 0 for a single plane (m)
+	float breakSlope;    // Slope along x beyond the break (dz/dx)
+	int numObstacles;    // Num. of boxes standing on the ground
+	float rangeNoise;    // Std. deviation of the range noise (m)
+	float mirrorRatio;   // Fraction of the ground returns turned into mirror reflections
+	float maxRange;      // Max. range of the sensor (m)
+	bool keepEmpty;      // Keep rays without return as zero points, as the SqueezeSeg padding
+};
+
+/*
+ *	Generates synthetic scans of a Velodyne sensor by casting one ray per laser and
+ *  azimuth column on a scene of a piecewise planar ground and box obstacles, so the
+ *  label of every point is known exactly: GROUND_LABEL for ground returns,
+ *  OBSTACLE_LABEL for obstacle returns and 0 for mirror reflections, which are moved
+ *  below THRESH_ERROR along their ray. Points are ordered by ring, with the ring grid
+ *  index n = ring * numColumns + column and the ring 0 being the lowest laser, as in
+ *  VelodyneDecoder. Every frame places new obstacles; the same seed always produces
+ *  the same frames.
+ */
+class SceneGenerator {
+public:
+	/*
+	 *	@params
+	 *		sensor model (VelodyneModel)
+	 *		num. of azimuth columns, i.e. rays per laser (int)
+	 *		scene parameters (sceneParams)
+	 *		seed of the random generator (unsigned int)
+	 */
+	SceneGenerator(VelodyneModel model, int numColumns, const sceneParams& params, unsigned int seed);
+
+	/*
+	 *	Generates the next frame.
+	 *
+	 *  @params
+	 *  	reference to pointcloud (vector<point_XYZIRL>)
+	 *  @return number of ground points (int)
+	 */
+	int generate(std::vector<point_XYZIRL>& frame);
+
+	/*
+	 *	Gets the height of the ground at a position.
+	 *
+	 *  @params
+	 *  	x, y (float)
+	 *  @return z of the ground (float)
+	 */
+	float getGroundHeight(float x, float y) const;
+
+	int getNumRings() const { return elevations.size(); }
+
+private:
+	struct box {
+		float min[3];
+		float max[3];
+	};
+
+	int numColumns;
+	sceneParams params;
+	std::mt19937 generator;
+	std::vector<float> elevations;  // Sorted from the lowest laser
+	std::vector<box> obstacles;
+
+	void placeObstacles();
+	float castGround(const float direction[3]) const;
+	float castObstacles(const float direction[3]) const;
+};
+
+#endif
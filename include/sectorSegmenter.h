@@ -0,0 +1,83 @@
+#ifndef SECTORSEGMENTER_H
+#define SECTORSEGMENTER_H
+
+#include "groundExtractor.h"
+
+/*
+ *	Streaming version of the GLA that segments every azimuth sector of a revolution
+ *  as soon as its packets have arrived, instead of waiting for the whole scan. Each
+ *  sector has its own plane model, warm-started from the plane of the neighbouring
+ *  sector of the same revolution and the plane of the same sector in the previous
+ *  revolution: the initial seeds are the points close to the blended prior plane,
+ *  and the LPR seeds are used when there is no prior or it does not fit anymore.
+ */
+class SectorSegmenter {
+public:
+	/*
+	 *	@params
+	 *		num. of sectors per revolution (int)
+	 *		algorithm parameters (groundParams)
+	 */
+	SectorSegmenter(int numSectors, const groundParams& params);
+
+	/*
+	 *	Labels the ground points of a sector. Sectors are expected in the order they are
+	 *  swept; a sector index lower than the previous one starts a new revolution.
+	 *
+	 *  @params
+	 *  	reference to the points of the sector (vector<point_XYZIRL>)
+	 * 		index of the sector (int)
+	 *      reference to labeled sector, mirror-filtered points included (vector<point_XYZIRL>)
+	 *  @return number of ground points found (int)
+	 */
+	int segmentSector(std::vector<point_XYZIRL>& sector, int sectorIndex, std::vector<point_XYZIRL>& labeledSector);
+
+	/*
+	 *	Gets the labeled points of the last completed revolution.
+	 *
+	 *  @params
+	 *  	reference to labeled pointcloud (vector<point_XYZIRL>)
+	 *  @return 1 if a revolution was completed since the last call, 0 if not
+	 */
+	int getRevolution(std::vector<point_XYZIRL>& revolution);
+
+	/*
+	 *	Gets the labeled points of the revolution in progress, e.g. at the end of a stream.
+	 *
+	 *  @params
+	 *  	reference to labeled pointcloud (vector<point_XYZIRL>)
+	 *  @return 1 if the revolution had points, 0 if not
+	 */
+	int flush(std::vector<point_XYZIRL>& revolution);
+
+	/*
+	 *	Same as getRevolution and flush, also returning the plane and fit statistics 
+	 *  of every sector of the revolution.
+	 *
+	 *  @params
+	 *  	reference to labeled pointcloud (vector<point_XYZIRL>)
+	 * 		reference to the statistics of the sectors (vector<segmentStats>)
+	 *  @return 1 if a revolution was returned, 0 if not
+	 */
+	int getRevolution(std::vector<point_XYZIRL>& revolution, std::vector<segmentStats>& stats);
+	int flush(std::vector<point_XYZIRL>& revolution, std::vector<segmentStats>& stats);
+
+private:
+	int numSectors;
+	groundParams params;
+	int lastSector;
+	int numRevolution;
+	bool revolutionReady;
+	std::vector<planeModel> planes;
+	std::vector<int> planeRevolutions;  // Revolution in which each sector plane was estimated
+	std::vector<point_XYZIRL> current;
+	std::vector<point_XYZIRL> completed;
+	std::vector<segmentStats> currentStats;
+	std::vector<segmentStats> completedStats;
+	std::vector<point_XYZIRL> seeds;
+	std::vector<point_XYZIRL> filtered;
+
+	int getPriorPlane(int sectorIndex, planeModel& prior) const;
+};
+
+#endif
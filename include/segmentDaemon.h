@@ -0,0 +1,154 @@
+#ifndef SEGMENTDAEMON_H
+#define SEGMENTDAEMON_H
+
+#include "groundSegmenter.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+#define DAEMON_PROTOCOL_VERSION 1
+#define DAEMON_MAX_SLOTS        64
+#define DAEMON_POLL_MS          200  // Period the daemon checks if it has to stop
+
+/*
+ *	Protocol of the segmentation daemon. Every client creates a ring of frame slots in
+ *  shared memory and passes its file descriptor to the daemon with the HELLO message
+ *  (SCM_RIGHTS). Every slot holds the x, y and z of up to maxPoints points, interleaved,
+ *  followed by their labels. The client fills a slot and sends SUBMIT; the daemon
+ *  labels it in place and answers DONE, in the order the slots were submitted. Control
+ *  messages are fixed-size datagrams over a SOCK_SEQPACKET Unix domain socket.
+ */
+enum DaemonMessageType {
+	DAEMON_HELLO,   // Client: ring with numSlots slots of maxPoints points
+	DAEMON_READY,   // Daemon: ring mapped, frames can be submitted
+	DAEMON_SUBMIT,  // Client: slot holds numPoints points to label
+	DAEMON_DONE,    // Daemon: slot labeled, numGround points are ground
+	DAEMON_ERROR    // Daemon: HELLO or SUBMIT not valid, the connection is closed
+};
+
+struct daemonMessage {
+	int type;       // DaemonMessageType
+	int version;    // DAEMON_PROTOCOL_VERSION (HELLO, READY)
+	int numSlots;   // Slots of the ring (HELLO)
+	int maxPoints;  // Max. points per slot (HELLO)
+	int slot;       // Slot of the frame (SUBMIT, DONE)
+	int numPoints;  // Points of the frame (SUBMIT, DONE)
+	int numGround;  // Ground points found (DONE)
+	float time;     // Milliseconds spent labeling the frame in the daemon (DONE)
+};
+
+/*
+ *	Gets the size of a slot of the ring, a multiple of 64 bytes so slots do not share
+ *  cache lines.
+ *
+ *  @params
+ *  	max. points per slot (int)
+ *  @return bytes (size_t)
+ */
+size_t getDaemonSlotSize(int maxPoints);
+
+/*
+ *	Gets the points of a slot: x, y and z of every point.
+ *
+ *  @params
+ *  	ring (void*)
+ * 		slot (int)
+ * 		max. points per slot (int)
+ *  @return points (float*)
+ */
+float* getDaemonSlotPoints(void* ring, int slot, int maxPoints);
+
+/*
+ *	Gets the labels of a slot, after its points.
+ *
+ *  @params
+ *  	ring (void*)
+ * 		slot (int)
+ * 		max. points per slot (int)
+ *  @return labels (unsigned char*)
+ */
+unsigned char* getDaemonSlotLabels(void* ring, int slot, int maxPoints);
+
+/*
+ *	Sends a control message, with a file descriptor attached if given.
+ *
+ *  @params
+ *  	socket (int)
+ * 		message (daemonMessage)
+ * 		file descriptor to pass, -1 for none (int)
+ *  @return 1 if successful, 0 if not
+ */
+int sendDaemonMessage(int sock, const daemonMessage& message, int fd);
+
+/*
+ *	Receives a control message, and the file descriptor attached to it if any.
+ *
+ *  @params
+ *  	socket (int)
+ * 		reference to message (daemonMessage)
+ * 		reference to the file descriptor received, -1 if none; NULL to close any (int*)
+ *  @return 1 if a message was received, 0 on disconnection or error
+ */
+int receiveDaemonMessage(int sock, daemonMessage& message, int* fd);
+
+/*
+ *	Resident segmentation server. A pool of worker threads, each with its own warm
+ *  GroundSegmenter, is started with the daemon; every accepted client is served by one
+ *  worker until it disconnects, so there are as many concurrent clients as workers and
+ *  later ones wait in the accept queue.
+ */
+class SegmentDaemon {
+public:
+	/*
+	 *	@params
+	 *		algorithm parameters (groundParams)
+	 * 		skip points at the origin (bool)
+	 * 		warm-start the seeds from the previous frame of the same client (bool)
+	 * 		num. of worker threads (int)
+	 */
+	SegmentDaemon(const groundParams& params, bool skipZero, bool temporal, int numWorkers);
+	~SegmentDaemon();
+
+	/*
+	 *	Listens on a Unix domain socket, replacing a stale socket file.
+	 *
+	 *  @params
+	 *  	socket path (string)
+	 *  @return 1 if successful, 0 if not
+	 */
+	int open(std::string socketPath);
+
+	/*
+	 *	Accepts and serves clients until stop is called, or SIGINT or SIGTERM received.
+	 *
+	 *  @return num. of clients served (int)
+	 */
+	int run();
+
+	/*
+	 *	Makes run return and disconnects the clients. Safe from any thread.
+	 */
+	void stop();
+
+private:
+	struct worker {
+		GroundSegmenter segmenter;
+		int client;  // Socket of the client being served, -1 if idle
+		worker(const groundParams& params) : segmenter(params), client(-1) {}
+	};
+
+	std::string path;
+	int sock;
+	volatile bool stopping;
+	std::vector<worker*> workers;
+	std::vector<std::thread> threads;
+	std::deque<int> pending;  // Accepted clients waiting for a worker
+	std::mutex mutex;
+	std::condition_variable ready;
+
+	void work(worker* w);
+	void serve(worker* w, int client);
+};
+
+#endif
@@ -9,6 +9,18 @@ struct point_XYZIRL {
 	float r;  // range
 	float l;  // label
 	float n;  // Line number
+	float h;  // Height above the ground plane (NAN if unknown)
+	int idx;  // Position of the point in the input (file line or decoded order)
 }; 
 
+struct groundParams {
+	int numLPR;        // Num. of points used to estimate the LPR
+	int numSegments;   // Num. of segments along the x-axis
+	int numIters;      // Num. of plane estimations per segment
+	float seedThresh;  // Max. value to determine a seed
+	float distThresh;  // Max. value to determine ground distance
+	bool method;       // Use means (true) or medians (false)
+	bool polarGrid;    // Segment on a polar grid instead of along the x-axis
+};
+
 #endif
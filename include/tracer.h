@@ -0,0 +1,84 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <string>
+#include <chrono>
+
+#define TRACE_BUFFER_EVENTS 65536 // Events kept per thread, the oldest are overwritten
+
+/*
+ *	Trace scopes are only compiled with -DGLA_TRACE (cmake -DGLA_TRACE=ON); otherwise
+ *  TRACE_SCOPE expands to nothing and costs nothing.
+ *
+ *	    {
+ *	        TRACE_SCOPE("segment", segmentIndex);
+ *	        ...
+ *	    }
+ */
+#ifdef GLA_TRACE
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+#define TRACE_SCOPE(name, id) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name, id)
+#define TRACE_ENABLED() isTracing()
+#else
+#define TRACE_SCOPE(name, id)
+#define TRACE_ENABLED() false
+#endif
+
+/*
+ *	Enables the tracer and sets the origin of the event times.
+ *
+ *  @params
+ *  	enable (bool)
+ *  @return void
+ */
+void enableTracer(bool enabled);
+
+/*
+ *	Checks if the tracer is enabled.
+ *
+ *  @return true if enabled
+ */
+bool isTracing();
+
+/*
+ *	Records a completed event in the ring buffer of the calling thread. Buffers are
+ *  only written by their own thread, so recording takes no lock.
+ *
+ *  @params
+ *  	name, must outlive the tracer (const char*)
+ * 		id shown as argument of the event, -1 for none (int)
+ * 		begin and end time (steady_clock::time_point)
+ *  @return void
+ */
+void addTraceEvent(const char* name, int id, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+
+/*
+ *	Saves the events of every thread in the Chrome trace format (JSON), which can be
+ *  opened with chrome://tracing or ui.perfetto.dev. Must be called while no thread
+ *  is recording.
+ *
+ *  @params
+ *  	file path (string)
+ *  @return 1 if successful, 0 if not
+ */
+int saveTrace(std::string pathToFile);
+
+// Records the enclosing scope as an event, use TRACE_SCOPE
+class TraceScope {
+public:
+	TraceScope(const char* name, int id) : name(name), id(id), active(isTracing()) {
+		if (active) begin = std::chrono::steady_clock::now();
+	}
+	~TraceScope() {
+		if (active) addTraceEvent(name, id, begin, std::chrono::steady_clock::now());
+	}
+
+private:
+	const char* name;
+	int id;
+	bool active;
+	std::chrono::steady_clock::time_point begin;
+};
+
+#endif
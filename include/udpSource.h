@@ -0,0 +1,62 @@
+#ifndef UDPSOURCE_H
+#define UDPSOURCE_H
+
+#include <sys/socket.h>
+#include "includes.h"
+
+#define UDP_BATCH       64
+#define UDP_PACKET_SIZE 2048
+#define UDP_RECV_BUFFER (8 << 20)
+
+/*
+ *	Receiver of UDP datagrams (e.g. Velodyne data packets). Datagrams are read in
+ *  batches with recvmmsg into preallocated buffers, so a whole burst of packets
+ *  costs a single system call.
+ */
+class UdpSource {
+public:
+	UdpSource();
+	~UdpSource();
+
+	/*
+	 *	Binds a socket to the given port on every interface.
+	 *
+	 *  @params
+	 *  	UDP port (int)
+	 *  @return 1 if successful, 0 if not
+	 */
+	int open(int port);
+
+	/*
+	 *	Waits for datagrams and receives up to UDP_BATCH of them. Waits interrupted
+	 *	by a signal and wakeups with nothing to read keep waiting.
+	 *
+	 *  @params
+	 *  	max. time to wait in milliseconds, -1 waits forever (int)
+	 *  @return number of datagrams received, 0 on timeout, -1 on error
+	 */
+	int receive(int timeoutMs);
+
+	/*
+	 *	Gets a datagram of the last batch.
+	 *
+	 *  @params
+	 *  	index in the batch (int)
+	 * 		reference to payload size (size_t)
+	 *  @return payload (const unsigned char*)
+	 */
+	const unsigned char* getPacket(int i, size_t& size) const;
+
+	/*
+	 *	Closes the socket.
+	 */
+	void close();
+
+private:
+	int sock;
+	std::vector<unsigned char> buffers;
+	std::vector<struct mmsghdr> messages;
+	std::vector<struct iovec> iovecs;
+};
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef VELODYNEDECODER_H
+#define VELODYNEDECODER_H
+
+#include <deque>
+#include "includes.h"
+
+#define VELODYNE_PACKET_SIZE     1206
+#define VELODYNE_BLOCKS          12
+#define VELODYNE_CHANNELS        32
+#define VELODYNE_AZIMUTH_STEPS   36000 // Azimuth is reported in hundredths of degree
+#define VELODYNE_DIST_RESOLUTION 0.002f
+
+enum VelodyneModel { VLP16, HDL32, HDL64 };
+
+/*
+ *	Parses the name of a sensor model (vlp16, hdl32 or hdl64).
+ *
+ *  @params
+ *  	model name (string)
+ * 		reference to model (VelodyneModel)
+ *  @return 1 if successful, 0 if not
+ */
+int parseVelodyneModel(std::string name, VelodyneModel& model);
+
+/*
+ *	Gets the vertical angle of every laser of a sensor model, in firing order.
+ *
+ *  @params
+ *  	sensor model (VelodyneModel)
+ * 		reference to the elevations in degrees (vector<float>)
+ *  @return number of lasers (int)
+ */
+int getVelodyneElevations(VelodyneModel model, std::vector<float>& elevations);
+
+/*
+ *	Decoder of raw Velodyne UDP data packets. Points are converted with precomputed
+ *  sin/cos tables for every azimuth step and laser, and assembled into revolutions
+ *  which are cut where the azimuth wraps around. Each point gets its range, its
+ *  normalized intensity and, in the n field, its index in a (ring x column) grid
+ *  flattened by ring, the same layout used by the SqueezeSeg frames, and in the idx
+ *  field its position in the revolution in decoding order. Ring 0 is the lowest 
+ *  laser. Elevations of the HDL-64 are the nominal ones, not the per-unit calibration.
+ */
+class VelodyneDecoder {
+public:
+	/*
+	 *	@params
+	 *		sensor model (VelodyneModel)
+	 *		num. of azimuth columns of the ring x column grid (int)
+	 */
+	VelodyneDecoder(VelodyneModel model, int numColumns);
+
+	/*
+	 *	Unpacks a data packet into the current revolution.
+	 *
+	 *  @params
+	 *  	packet payload (const unsigned char*)
+	 * 		payload size (size_t)
+	 *  @return number of completed revolutions waiting to be read, -1 if the packet is invalid
+	 */
+	int decodePacket(const unsigned char* packet, size_t size);
+
+	/*
+	 *	Moves the oldest completed revolution into scan.
+	 *
+	 *  @params
+	 *  	reference to pointcloud (vector<point_XYZIRL>)
+	 *  @return 1 if a revolution was returned, 0 if none is completed
+	 */
+	int getScan(std::vector<point_XYZIRL>& scan);
+
+	/*
+	 *	Moves the revolution being assembled into scan, e.g. at the end of a capture.
+	 *
+	 *  @params
+	 *  	reference to pointcloud (vector<point_XYZIRL>)
+	 *  @return 1 if the revolution had points, 0 if not
+	 */
+	int flush(std::vector<point_XYZIRL>& scan);
+
+	/*
+	 *	Splits every revolution into numSectors azimuth sectors that are completed, and
+	 *  can be read with getScan, as soon as the sensor leaves them. Default is 1.
+	 *
+	 *  @params
+	 *  	num. of sectors per revolution (int)
+	 */
+	void setSectors(int numSectors);
+
+	/*
+	 *	Same as getScan, also returning the index of the sector of the points.
+	 *
+	 *  @params
+	 *  	reference to pointcloud (vector<point_XYZIRL>)
+	 * 		reference to the sector index (int)
+	 *  @return 1 if a sector was returned, 0 if none is completed
+	 */
+	int getScan(std::vector<point_XYZIRL>& scan, int& sector);
+
+	int getCurrentSector() const { return currentSector; }
+	int getNumRings() const { return numLasers; }
+	int getNumColumns() const { return numColumns; }
+
+private:
+	VelodyneModel model;
+	int numLasers;
+	int numColumns;
+	int lastAzimuth;
+	int numSectors;
+	int currentSector;
+	int numDecoded;  // Points decoded in the current revolution
+	std::vector<float> sinAzimuth;
+	std::vector<float> cosAzimuth;
+	std::vector<float> sinElevation;
+	std::vector<float> cosElevation;
+	std::vector<int> rings;
+	std::vector<point_XYZIRL> current;
+	std::deque<std::vector<point_XYZIRL> > scans;
+	std::deque<int> scanSectors;
+
+	void addFiring(const unsigned char* channels, int numChannels, int laserBase, int azimuth);
+};
+
+#endif
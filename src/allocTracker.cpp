@@ -0,0 +1,120 @@
+#include "allocTracker.h"
+#include <atomic>
+#include <malloc.h>
+#include <errno.h>
+
+static std::atomic<long long> scopeAllocations[MAX_ALLOC_SCOPES];
+static std::atomic<long long> scopeBytes[MAX_ALLOC_SCOPES];
+static std::atomic<long long> scopePeaks[MAX_ALLOC_SCOPES];
+static std::atomic<long long> totalAllocations(0);
+static std::atomic<long long> totalBytes(0);
+static std::atomic<long long> liveBytes(0);
+static std::atomic<long long> peakBytes(0);
+static thread_local int currentScope = NO_ALLOC_SCOPE;
+
+// Set the scope of the allocations of the calling thread
+int setAllocationScope(int scope) {
+	int previous = currentScope;
+	currentScope = scope;
+	return previous;
+}
+
+// Get the allocations of a scope
+void getAllocationStats(int scope, allocStats& stats) {
+	stats.allocations = scopeAllocations[scope];
+	stats.bytes = scopeBytes[scope];
+	stats.peakBytes = scopePeaks[scope];
+}
+
+// Get the allocations of the process
+void getAllocationTotals(allocStats& stats) {
+	stats.allocations = totalAllocations;
+	stats.bytes = totalBytes;
+	stats.peakBytes = peakBytes;
+}
+
+// Restart the peak of the process
+void resetAllocationPeak() {
+	peakBytes = liveBytes.load();
+}
+
+#ifdef GLA_ALLOC_TRACK
+// Raise a peak to a new value
+static void updatePeak(std::atomic<long long>& peak, long long value) {
+	long long current = peak.load(std::memory_order_relaxed);
+	while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed));
+}
+
+// Count an allocated block
+static void recordAllocation(void* block) {
+	if (block == NULL) return;
+	long long size = malloc_usable_size(block);
+	long long live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	totalAllocations.fetch_add(1, std::memory_order_relaxed);
+	totalBytes.fetch_add(size, std::memory_order_relaxed);
+	updatePeak(peakBytes, live);
+	int scope = currentScope;
+	if (scope >= 0 && scope < MAX_ALLOC_SCOPES) {
+		scopeAllocations[scope].fetch_add(1, std::memory_order_relaxed);
+		scopeBytes[scope].fetch_add(size, std::memory_order_relaxed);
+		updatePeak(scopePeaks[scope], live);
+	}
+}
+
+// Count a freed block
+static void recordFree(void* block) {
+	if (block != NULL) liveBytes.fetch_sub(malloc_usable_size(block), std::memory_order_relaxed);
+}
+
+// Replacements of the glibc allocator, which forward to its internal entry points
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* block, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* block);
+
+void* malloc(size_t size) {
+	void* block = __libc_malloc(size);
+	recordAllocation(block);
+	return block;
+}
+
+void* calloc(size_t count, size_t size) {
+	void* block = __libc_calloc(count, size);
+	recordAllocation(block);
+	return block;
+}
+
+void* realloc(void* block, size_t size) {
+	recordFree(block);
+	void* resized = __libc_realloc(block, size);
+	if (resized == NULL && size > 0 && block != NULL) recordAllocation(block); // Old block is kept
+	else recordAllocation(resized);
+	return resized;
+}
+
+void* memalign(size_t alignment, size_t size) {
+	void* block = __libc_memalign(alignment, size);
+	recordAllocation(block);
+	return block;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+	return memalign(alignment, size);
+}
+
+int posix_memalign(void** block, size_t alignment, size_t size) {
+	if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+	void* aligned = memalign(alignment, size);
+	if (aligned == NULL && size > 0) return ENOMEM;
+	*block = aligned;
+	return 0;
+}
+
+void free(void* block) {
+	recordFree(block);
+	__libc_free(block);
+}
+}
+#endif
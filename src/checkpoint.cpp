@@ -0,0 +1,93 @@
+#include "checkpoint.h"
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <stdio.h>
+#include <unistd.h>
+
+#define CHECKPOINT_HEADER "# input\toutput\tpoints\tground\tms\tcontent\tparams"
+
+// Format hash as hex
+static std::string formatHash(unsigned long long hash) {
+	char text[17];
+	snprintf(text, sizeof(text), "%016llx", hash);
+	return text;
+}
+
+// Write entry as a line
+static void writeEntry(std::ostream& file, const checkpointEntry& entry) {
+	const manifestEntry& frame = entry.frame;
+	file << frame.input << "\t" << frame.output << "\t" << frame.numPoints << "\t" << frame.numGround << "\t"
+	     << frame.time << "\t" << entry.contentHash << "\t" << entry.paramsHash << "\n";
+}
+
+// Hash file content
+int getFileHash(std::string path, std::string& hash) {
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == NULL) return 0;
+	std::vector<char> buffer(CHECKPOINT_READ_SIZE);
+	unsigned long long value = FNV_OFFSET;
+	size_t size;
+	while ((size = fread(&buffer[0], 1, buffer.size(), file)) > 0) value = getFnvHash(&buffer[0], size, value);
+	bool failed = ferror(file);
+	fclose(file);
+	if (failed) return 0;
+	hash = formatHash(value);
+	return 1;
+}
+
+// Hash text
+std::string getTextHash(const std::string& text) {
+	return formatHash(getFnvHash(text.data(), text.size(), FNV_OFFSET));
+}
+
+// Read checkpoint
+int readCheckpoint(std::string path, std::map<std::string, checkpointEntry>& entries) {
+	std::ifstream file(path.c_str());
+	if (file.fail()) return access(path.c_str(), F_OK) != 0; // Missing: nothing done yet
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') continue;
+		if (file.eof()) break; // Last line without newline: cut short
+		std::vector<std::string> fields;
+		boost::split(fields, line, boost::is_any_of("\t"));
+		if (fields.size() != 7) continue;
+		checkpointEntry entry;
+		entry.frame.input  = fields[0];
+		entry.frame.output = fields[1];
+		try {
+			entry.frame.numPoints = boost::lexical_cast<long>(fields[2]);
+			entry.frame.numGround = boost::lexical_cast<long>(fields[3]);
+			entry.frame.time      = boost::lexical_cast<double>(fields[4]);
+		} catch (boost::bad_lexical_cast&) {
+			continue;
+		}
+		entry.contentHash = fields[5];
+		entry.paramsHash  = fields[6];
+		entries[entry.frame.input] = entry;
+	}
+	return 1;
+}
+
+// Rewrite checkpoint
+int saveCheckpoint(std::string path, const std::map<std::string, checkpointEntry>& entries) {
+	std::string tempPath = path + ".tmp";
+	std::ofstream file(tempPath.c_str(), std::ios::trunc);
+	if (file.fail()) return 0;
+	file << CHECKPOINT_HEADER << "\n";
+	for (std::map<std::string, checkpointEntry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+		writeEntry(file, it->second);
+	}
+	file.close();
+	if (file.fail()) return 0;
+	return rename(tempPath.c_str(), path.c_str()) == 0;
+}
+
+// Append entry to checkpoint
+int saveCheckpointEntry(std::string path, const checkpointEntry& entry) {
+	std::ofstream file(path.c_str(), std::fstream::app);
+	if (file.fail()) return 0;
+	if (file.tellp() == 0) file << CHECKPOINT_HEADER << "\n";
+	writeEntry(file, entry);
+	file.flush();
+	return !file.fail();
+}
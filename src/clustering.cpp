@@ -0,0 +1,268 @@
+#include "clustering.h"
+#include "rangeImage.h"
+#include <atomic>
+#include <math.h>
+#include <stdint.h>
+
+#define SLR_NEIGHBOUR_COLUMNS 2 // Columns searched at each side in the previous ring
+#define EMPTY_VOXEL ~0ULL       // Key of the free slots of the voxel table
+
+// Union-find helpers, labels point to their parent
+static int findRoot(std::vector<int>& parents, int label) {
+	while (parents[label] != label) {
+		parents[label] = parents[parents[label]]; // Path halving
+		label = parents[label];
+	}
+	return label;
+}
+static void mergeLabels(std::vector<int>& parents, int a, int b) {
+	a = findRoot(parents, a);
+	b = findRoot(parents, b);
+	if (a < b) parents[b] = a;
+	else if (b < a) parents[a] = b;
+}
+
+static float squaredDistance(const point_XYZIRL& p1, const point_XYZIRL& p2) {
+	float dx = p1.x - p2.x;
+	float dy = p1.y - p2.y;
+	float dz = p1.z - p2.z;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+// Ground points and points without return are not clustered
+static bool isClustered(const point_XYZIRL& p) {
+	return p.l != GROUND_LABEL && !(p.x == 0 && p.y == 0 && p.z == 0);
+}
+
+// Parse clustering method name
+int parseClusterMethod(std::string name, ClusterMethod& method) {
+	if (name == "none") method = CLUSTER_NONE;
+	else if (name == "slr") method = CLUSTER_SLR;
+	else if (name == "voxel") method = CLUSTER_VOXEL;
+	else return 0;
+	return 1;
+}
+
+// Scan Line Run clustering
+int clusterScanLineRuns(const std::vector<point_XYZIRL>& pointCloud, const clusterParams& params, std::vector<int>& clusterIds) {
+	clusterIds.assign(pointCloud.size(), NO_CLUSTER);
+	RangeImage image(params.numColumns);
+	image.build(pointCloud);
+	int numRings = image.getNumRings();
+	int numColumns = image.getNumColumns();
+
+	float runThresh = params.runThresh * params.runThresh;
+	float mergeThresh = params.mergeThresh * params.mergeThresh;
+	std::vector<int> runs(pointCloud.size(), -1); // Run label of every point
+	std::vector<int> parents;
+	for (int ring = 0; ring < numRings; ring++) {
+
+		// Split the ring into runs
+		int previous = -1;
+		int first = -1;
+		for (int col = 0; col < numColumns; col++) {
+			int i = image.getIndex(ring, col);
+			if (i == EMPTY_CELL || !isClustered(pointCloud[i])) continue;
+			if (previous < 0 || squaredDistance(pointCloud[i], pointCloud[previous]) > runThresh) {
+				runs[i] = parents.size();
+				parents.push_back(runs[i]);
+			} else {
+				runs[i] = runs[previous];
+			}
+			if (first < 0) first = i;
+			previous = i;
+		}
+		// The ring is closed, the last run may continue in the first one
+		if (first >= 0 && previous != first && squaredDistance(pointCloud[first], pointCloud[previous]) <= runThresh) {
+			mergeLabels(parents, runs[first], runs[previous]);
+		}
+
+		// Merge with the runs of the previous ring
+		if (ring == 0) continue;
+		for (int col = 0; col < numColumns; col++) {
+			int i = image.getIndex(ring, col);
+			if (i == EMPTY_CELL || runs[i] < 0) continue;
+			const point_XYZIRL& p = image.getPoint(ring, col);
+			for (int c = col - SLR_NEIGHBOUR_COLUMNS; c <= col + SLR_NEIGHBOUR_COLUMNS; c++) {
+				int j = image.getIndex(ring - 1, image.wrapColumn(c));
+				if (j != EMPTY_CELL && runs[j] >= 0 && squaredDistance(p, image.getPoint(ring - 1, image.wrapColumn(c))) <= mergeThresh) {
+					mergeLabels(parents, runs[i], runs[j]);
+				}
+			}
+		}
+	}
+
+	// Points sharing a cell join the run of the point in the cell when close enough
+	const std::vector<int>& overflow = image.getOverflow();
+	for (int k = 0; k < overflow.size(); k++) {
+		int i = overflow[k];
+		int cell = pointCloud[i].n;
+		if (!isClustered(pointCloud[i])) continue;
+		int j = cell >= 0 ? image.getIndex(cell / numColumns, cell % numColumns) : EMPTY_CELL;
+		if (j != EMPTY_CELL && runs[j] >= 0 && squaredDistance(pointCloud[i], pointCloud[j]) <= runThresh) {
+			runs[i] = runs[j];
+		} else {
+			runs[i] = parents.size();
+			parents.push_back(runs[i]);
+		}
+	}
+
+	// Resolve equivalences into consecutive cluster ids
+	std::vector<int> ids(parents.size(), NO_CLUSTER);
+	int numClusters = 0;
+	for (int i = 0; i < pointCloud.size(); i++) {
+		if (runs[i] < 0) continue;
+		int root = findRoot(parents, runs[i]);
+		if (ids[root] == NO_CLUSTER) ids[root] = ++numClusters;
+		clusterIds[i] = ids[root];
+	}
+	return numClusters;
+}
+
+// Lock-free union-find helpers, roots only get linked under smaller roots
+static int findRoot(std::vector<std::atomic<int> >& parents, int label) {
+	while (true) {
+		int parent = parents[label].load();
+		if (parent == label) return label;
+		int grandParent = parents[parent].load();
+		if (parent != grandParent) parents[label].compare_exchange_weak(parent, grandParent);
+		label = grandParent;
+	}
+}
+static void mergeLabels(std::vector<std::atomic<int> >& parents, int a, int b) {
+	while (true) {
+		a = findRoot(parents, a);
+		b = findRoot(parents, b);
+		if (a == b) return;
+		if (a > b) std::swap(a, b);
+		int expected = b;
+		if (parents[b].compare_exchange_strong(expected, a)) return;
+	}
+}
+
+// Pack voxel coordinates (21 bits each) into a hash key
+static uint64_t voxelKey(int vx, int vy, int vz) {
+	const uint64_t mask = (1 << 21) - 1;
+	return ((uint64_t)(vx & mask) << 42) | ((uint64_t)(vy & mask) << 21) | (uint64_t)(vz & mask);
+}
+static uint64_t hashKey(uint64_t key) {
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return key;
+}
+
+// Flat open-addressing table from voxel keys to voxel indices
+class VoxelTable {
+public:
+	VoxelTable(size_t numKeys) {
+		size_t capacity = 16;
+		while (capacity < 2 * numKeys) capacity <<= 1;
+		keys.assign(capacity, EMPTY_VOXEL);
+		values.resize(capacity);
+		mask = capacity - 1;
+	}
+	int insert(uint64_t key, int value) {
+		size_t slot = hashKey(key) & mask;
+		while (keys[slot] != EMPTY_VOXEL && keys[slot] != key) slot = (slot + 1) & mask;
+		if (keys[slot] == EMPTY_VOXEL) {
+			keys[slot] = key;
+			values[slot] = value;
+		}
+		return values[slot];
+	}
+	int find(uint64_t key) const {
+		size_t slot = hashKey(key) & mask;
+		while (keys[slot] != EMPTY_VOXEL) {
+			if (keys[slot] == key) return values[slot];
+			slot = (slot + 1) & mask;
+		}
+		return -1;
+	}
+private:
+	std::vector<uint64_t> keys;
+	std::vector<int> values;
+	size_t mask;
+};
+
+// Voxel hash Euclidean clustering
+int clusterVoxelHash(const std::vector<point_XYZIRL>& pointCloud, const clusterParams& params, std::vector<int>& clusterIds) {
+	int numPoints = pointCloud.size();
+	clusterIds.assign(numPoints, NO_CLUSTER);
+	float tolerance = params.tolerance;
+	float maxDistance = tolerance * tolerance;
+
+	// Hash non-ground points into voxels of the tolerance size
+	std::vector<int> pointVoxels(numPoints, -1);
+	std::vector<int> voxelCoords; // vx, vy, vz of every voxel
+	VoxelTable table(numPoints);
+	for (int i = 0; i < numPoints; i++) {
+		const point_XYZIRL& p = pointCloud[i];
+		if (!isClustered(p)) continue;
+		int vx = floor(p.x / tolerance);
+		int vy = floor(p.y / tolerance);
+		int vz = floor(p.z / tolerance);
+		int voxel = table.insert(voxelKey(vx, vy, vz), voxelCoords.size() / 3);
+		if (voxel == voxelCoords.size() / 3) {
+			voxelCoords.push_back(vx);
+			voxelCoords.push_back(vy);
+			voxelCoords.push_back(vz);
+		}
+		pointVoxels[i] = voxel;
+	}
+
+	// Points of every voxel stored contiguously
+	int numVoxels = voxelCoords.size() / 3;
+	std::vector<int> voxelStart(numVoxels + 1, 0);
+	for (int i = 0; i < numPoints; i++) {
+		if (pointVoxels[i] >= 0) voxelStart[pointVoxels[i] + 1]++;
+	}
+	for (int v = 0; v < numVoxels; v++) voxelStart[v + 1] += voxelStart[v];
+	std::vector<int> voxelPoints(voxelStart[numVoxels]);
+	std::vector<int> voxelEnd(voxelStart.begin(), voxelStart.end() - 1);
+	for (int i = 0; i < numPoints; i++) {
+		if (pointVoxels[i] >= 0) voxelPoints[voxelEnd[pointVoxels[i]]++] = i;
+	}
+
+	// Connect close points of the same and neighbouring voxels, every pair of voxels once
+	std::vector<std::atomic<int> > parents(numPoints);
+	for (int i = 0; i < numPoints; i++) parents[i].store(i);
+	#pragma omp parallel for schedule(dynamic, 64)
+	for (int v = 0; v < numVoxels; v++) {
+		for (int dx = -1; dx <= 1; dx++) {
+			for (int dy = -1; dy <= 1; dy++) {
+				for (int dz = -1; dz <= 1; dz++) {
+					int u = table.find(voxelKey(voxelCoords[3 * v] + dx, voxelCoords[3 * v + 1] + dy, voxelCoords[3 * v + 2] + dz));
+					if (u < v) continue;
+					for (int a = voxelStart[v]; a < voxelStart[v + 1]; a++) {
+						int i = voxelPoints[a];
+						for (int b = (u == v ? a + 1 : voxelStart[u]); b < voxelStart[u + 1]; b++) {
+							int j = voxelPoints[b];
+							if (squaredDistance(pointCloud[i], pointCloud[j]) <= maxDistance) {
+								mergeLabels(parents, i, j);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// Consecutive cluster ids
+	int numClusters = 0;
+	for (int i = 0; i < numPoints; i++) {
+		if (pointVoxels[i] < 0) continue;
+		int root = findRoot(parents, i);
+		if (root == i) clusterIds[i] = ++numClusters;
+		else clusterIds[i] = clusterIds[root]; // Roots are the smallest index of their cluster
+	}
+	return numClusters;
+}
+
+// Run selected clustering method
+int clusterPoints(const std::vector<point_XYZIRL>& pointCloud, const clusterParams& params, std::vector<int>& clusterIds) {
+	clusterIds.clear();
+	if (params.method == CLUSTER_SLR) return clusterScanLineRuns(pointCloud, params, clusterIds);
+	if (params.method == CLUSTER_VOXEL) return clusterVoxelHash(pointCloud, params, clusterIds);
+	return 0;
+}
@@ -0,0 +1,109 @@
+#include "daemonClient.h"
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+DaemonClient::DaemonClient() : sock(-1), ring(MAP_FAILED), ringSize(0), numSlots(0), maxPoints(0), nextSlot(0), numPending(0) {
+}
+
+DaemonClient::~DaemonClient() {
+	close();
+}
+
+// Create ring and connect to daemon
+int DaemonClient::connect(std::string socketPath, int slots, int points) {
+	close();
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (slots <= 0 || slots > DAEMON_MAX_SLOTS || points <= 0 || socketPath.size() >= sizeof(address.sun_path)) return 0;
+	strcpy(address.sun_path, socketPath.c_str());
+
+	// Ring in an anonymous file, sealed so the daemon can map it safely
+	ringSize = slots * getDaemonSlotSize(points);
+	int ringFd = memfd_create("groundseg-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	if (ringFd < 0) return 0;
+	if (ftruncate(ringFd, ringSize) < 0 || fcntl(ringFd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_SEAL) < 0) {
+		::close(ringFd);
+		return 0;
+	}
+	ring = mmap(NULL, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, ringFd, 0);
+
+	// Pass the ring with the HELLO
+	daemonMessage message;
+	memset(&message, 0, sizeof(message));
+	message.type      = DAEMON_HELLO;
+	message.version   = DAEMON_PROTOCOL_VERSION;
+	message.numSlots  = slots;
+	message.maxPoints = points;
+	sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	bool connected = ring != MAP_FAILED && sock >= 0
+	              && ::connect(sock, (struct sockaddr*)&address, sizeof(address)) == 0
+	              && sendDaemonMessage(sock, message, ringFd)
+	              && receiveDaemonMessage(sock, message, NULL) && message.type == DAEMON_READY;
+	::close(ringFd);
+	if (!connected) {
+		close();
+		return 0;
+	}
+	numSlots = slots;
+	maxPoints = points;
+	slotPoints.assign(numSlots, 0);
+	return 1;
+}
+
+// Submit frame
+int DaemonClient::submit(const std::vector<point_XYZIRL>& pointCloud) {
+	if (sock < 0 || numPending == numSlots || pointCloud.size() > maxPoints) return 0;
+	float* points = getDaemonSlotPoints(ring, nextSlot, maxPoints);
+	for (int i = 0; i < pointCloud.size(); i++) {
+		points[3 * i]     = pointCloud[i].x;
+		points[3 * i + 1] = pointCloud[i].y;
+		points[3 * i + 2] = pointCloud[i].z;
+	}
+	daemonMessage message;
+	memset(&message, 0, sizeof(message));
+	message.type      = DAEMON_SUBMIT;
+	message.slot      = nextSlot;
+	message.numPoints = pointCloud.size();
+	if (!sendDaemonMessage(sock, message, -1)) return 0;
+	slotPoints[nextSlot] = pointCloud.size();
+	nextSlot = (nextSlot + 1) % numSlots;
+	numPending++;
+	return 1;
+}
+
+// Wait for oldest frame
+int DaemonClient::wait(std::vector<unsigned char>& labels, float* time) {
+	if (sock < 0 || numPending == 0) return -1;
+	int slot = (nextSlot - numPending + numSlots) % numSlots;
+	daemonMessage message;
+	if (!receiveDaemonMessage(sock, message, NULL) || message.type != DAEMON_DONE || message.slot != slot) {
+		close();
+		return -1;
+	}
+	numPending--;
+	const unsigned char* slotLabels = getDaemonSlotLabels(ring, slot, maxPoints);
+	labels.assign(slotLabels, slotLabels + slotPoints[slot]);
+	if (time) *time = message.time;
+	return message.numGround;
+}
+
+// Submit frame and wait for it
+int DaemonClient::segment(const std::vector<point_XYZIRL>& pointCloud, std::vector<unsigned char>& labels) {
+	if (numPending > 0 || !submit(pointCloud)) return -1;
+	return wait(labels);
+}
+
+// Disconnect
+void DaemonClient::close() {
+	if (sock >= 0) ::close(sock);
+	if (ring != MAP_FAILED) munmap(ring, ringSize);
+	sock = -1;
+	ring = MAP_FAILED;
+	numSlots = 0;
+	nextSlot = 0;
+	numPending = 0;
+}
@@ -0,0 +1,44 @@
+#include "groundEvaluation.h"
+
+// Move input labels into a ground truth mask
+int extractGroundTruth(std::vector<point_XYZIRL>& pointCloud, std::vector<unsigned char>& truth) {
+	int count = 0;
+	truth.assign(pointCloud.size(), 0);
+	for (int i = 0; i < pointCloud.size(); i++) {
+		point_XYZIRL& p = pointCloud[i];
+		if (p.idx >= truth.size()) truth.resize(p.idx + 1, 0);
+		truth[p.idx] = p.l == GROUND_LABEL;
+		count += truth[p.idx];
+		p.l = 0;
+	}
+	return count;
+}
+
+// Accumulate the confusion counts of a labeled cloud
+void scoreGroundLabels(const std::vector<point_XYZIRL>& labeledPointCloud, const std::vector<unsigned char>& truth, groundScore& score) {
+	long truthGround = 0;
+	for (size_t i = 0; i < truth.size(); i++) truthGround += truth[i];
+	long truePositives = 0;
+	for (int i = 0; i < labeledPointCloud.size(); i++) {
+		const point_XYZIRL& p = labeledPointCloud[i];
+		if (p.l != GROUND_LABEL) continue;
+		bool ground = p.idx >= 0 && p.idx < truth.size() && truth[p.idx];
+		if (ground) truePositives++;
+		else score.falsePositives++;
+	}
+	score.truePositives  += truePositives;
+	score.falseNegatives += truthGround - truePositives;
+	score.numPoints      += truth.size();
+}
+
+// Precision of the ground labels
+double getPrecision(const groundScore& score) {
+	long labeled = score.truePositives + score.falsePositives;
+	return labeled > 0 ? (double)score.truePositives / labeled : 1.0;
+}
+
+// Recall of the ground labels
+double getRecall(const groundScore& score) {
+	long ground = score.truePositives + score.falseNegatives;
+	return ground > 0 ? (double)score.truePositives / ground : 1.0;
+}
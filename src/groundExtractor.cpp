@@ -1,4 +1,7 @@
 #include "groundExtractor.h"
+#include "groundSegmenter.h"
+#include "profiler.h"
+#include <math.h>
 
 // Helper functions to sort vectors
 bool cmpZF(float p1, float p2) {
@@ -16,31 +19,45 @@ bool cmpX(point_XYZIRL& p1, point_XYZIRL& p2) {
 
 // Extract seeds to estimate initial ground plane
 void extractInitialSeedPoints(const std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZIRL>& seedPoints, int numLPR, float seedThresh, bool method) {
+	std::vector<float> scratch;
+	extractInitialSeedPoints(pointCloud.data(), pointCloud.size(), seedPoints, numLPR, seedThresh, method, scratch);
+}
+
+// Median of a buffer of values, reordering them
+static float getMedian(std::vector<float>& values) {
+	size_t size = values.size();
+	std::nth_element(values.begin(), values.begin() + size / 2, values.end());
+	float upper = values[size / 2];
+	if (size % 2 != 0) return upper;
+	float lower = *std::max_element(values.begin(), values.begin() + size / 2);
+	return (lower + upper) / 2;
+}
+
+// Extract seeds from a range of points
+void extractInitialSeedPoints(const point_XYZIRL* points, int numPoints, std::vector<point_XYZIRL>& seedPoints, int numLPR, float seedThresh, bool method, std::vector<float>& scratch) {
 
 	// Compute LPR
 	int count = 0;
 	float LPR;
 	if (method) { // Use means to estimate LPR (affected by outliers but faster)
 		float sum = 0.0;
-		for (int i = 0; i < numLPR && i < pointCloud.size(); i++) {
-			sum += pointCloud[i].z;
+		for (int i = 0; i < numLPR && i < numPoints; i++) {
+			sum += points[i].z;
 			count++;
 		}
 		LPR = count != 0 ? sum / count : 0.0; 
 	} else {      // Use medians to estimate LPR (helps removing outliers, but slower)
-		std::vector<float> tempZ;
-		for (int i = 0; i < numLPR && i < pointCloud.size(); i++) {
-			tempZ.push_back(pointCloud[i].z);
-			count++;
+		scratch.clear();
+		for (int i = 0; i < numLPR && i < numPoints; i++) {
+			scratch.push_back(points[i].z);
 		}
-		sort(tempZ.begin(), tempZ.end(), cmpZF);
-		LPR = count % 2 == 0 ? (tempZ[count / 2 - 1] + tempZ[count / 2 ]) / 2 : tempZ[count / 2]; 
+		LPR = scratch.empty() ? 0.0 : getMedian(scratch);
 	}
 	
 	// Determine seed points
-	for (int i = 0; i < pointCloud.size(); i++) {
-		if (pointCloud[i].z < LPR + seedThresh) {
-			seedPoints.push_back(pointCloud[i]);
+	for (int i = 0; i < numPoints; i++) {
+		if (points[i].z < LPR + seedThresh) {
+			seedPoints.push_back(points[i]);
 		}
 	}
 }
@@ -117,3 +134,141 @@ Eigen::MatrixXf estimatePlaneNormal(const std::vector<point_XYZIRL>& seeds, cons
 float getDistance(Eigen::MatrixXf vec3x1, Eigen::MatrixXf vec1x3) {
      return (vec3x1 * vec1x3)(0, 0);
 }      
+
+// Estimate the ground plane of a segment and label its ground points
+int fitGroundSegment(std::vector<point_XYZIRL>& segment, std::vector<point_XYZIRL>& seeds, const groundParams& params, planeModel& plane) {
+	std::vector<float> scratch;
+	return fitGroundSegment(segment.data(), segment.size(), seeds, scratch, params, plane);
+}
+
+// Mean or median of every coordinate of the seeds
+static Eigen::Vector3f getSeedCentroid(const std::vector<point_XYZIRL>& seeds, bool method, std::vector<float>& scratch) {
+	Eigen::Vector3f centroid = Eigen::Vector3f::Zero();
+	int numSeeds = seeds.size();
+	if (method) {
+		for (int i = 0; i < numSeeds; i++) {
+			centroid(0) += seeds[i].x;
+			centroid(1) += seeds[i].y;
+			centroid(2) += seeds[i].z;
+		}
+		centroid /= numSeeds;
+		return centroid;
+	}
+	for (int axis = 0; axis < 3; axis++) {
+		scratch.clear();
+		for (int i = 0; i < numSeeds; i++) scratch.push_back(axis == 0 ? seeds[i].x : axis == 1 ? seeds[i].y : seeds[i].z);
+		centroid(axis) = getMedian(scratch);
+	}
+	return centroid;
+}
+
+// Normal of the plane through the centroid of the seeds, on a fixed-size SVD
+static Eigen::Vector3f getSeedNormal(const std::vector<point_XYZIRL>& seeds, const Eigen::Vector3f& centroid) {
+	float xx = 0, yy = 0, zz = 0, xy = 0, xz = 0, yz = 0;
+	int numSeeds = seeds.size();
+	for (int i = 0; i < numSeeds; i++) {
+		float xTemp = seeds[i].x - centroid(0);
+		float yTemp = seeds[i].y - centroid(1);
+		float zTemp = seeds[i].z - centroid(2);
+		xx += xTemp * xTemp;
+		yy += yTemp * yTemp;
+		zz += zTemp * zTemp;
+		xy += xTemp * yTemp;
+		xz += xTemp * zTemp;
+		yz += yTemp * zTemp;
+	} 
+	Eigen::Matrix3f covarianceMat;
+	covarianceMat << xx, xy, xz, 
+	                 xy, yy, yz, 
+	                 xz, yz, zz;
+	covarianceMat /= numSeeds;
+	Eigen::JacobiSVD<Eigen::Matrix3f> svd(covarianceMat, Eigen::ComputeFullU);
+	return svd.matrixU().col(2);
+}
+
+// Estimate the ground plane of a range of points
+int fitGroundSegment(point_XYZIRL* segment, int numPoints, std::vector<point_XYZIRL>& seeds, std::vector<float>& scratch, const groundParams& params, planeModel& plane) {
+	int count = 0;
+	plane.valid = false;
+	plane.numSeeds = seeds.size();
+	plane.residual = 0;
+	if (seeds.empty()) return 0;
+
+	for (int iter = 0; iter < params.numIters; iter++) {
+		TRACE_SCOPE("iteration", iter);
+		//	The linear model to solve is: ax + by +cz + d = 0
+		//   		where; N = [a b c]     X = [x y z], 
+		//		           d = -(N.transpose * X)
+		Eigen::Vector3f normal;
+		float negDist;
+		float currDistThresh;
+		float sign;
+		{
+			StageScope scope(STAGE_FIT);
+			Eigen::Vector3f centroid = getSeedCentroid(seeds, params.method, scratch);
+			normal = getSeedNormal(seeds, centroid);
+			sign = normal(2) < 0 ? -1 : 1; // The sign of SVD is arbitrary
+			if (params.polarGrid) { // Bins label on upward normals, like the planes they inherit
+				normal *= sign;
+				sign = 1;
+			}
+			negDist = -(normal(0) * centroid(0) + normal(1) * centroid(1) + normal(2) * centroid(2)); // d = -(n.T * X)
+			currDistThresh = params.distThresh - negDist;  // Max ground distance of current model
+		}
+		// Segments label on the normal as SVD returns it, the plane keeps it pointing up
+		// so planes can be averaged
+		plane.normal = sign * normal;
+		plane.negDist = sign * negDist;
+		plane.numSeeds = seeds.size();
+		plane.valid = true;
+
+		// Calculate the distance for each point and compare it with current threshold to 
+		// determine if it is a ground point or not. 
+		seeds.clear();
+		if (iter < params.numIters-1) {  // Continue estimating plane
+			StageScope scope(STAGE_FIT);
+			for (int i = 0; i < numPoints; i++) {
+				const point_XYZIRL& p = segment[i];
+				if (p.x * normal(0) + p.y * normal(1) + p.z * normal(2) < currDistThresh) {
+					seeds.push_back(p);
+				}
+			}
+		} else { // Label final point cloud segment
+			StageScope scope(STAGE_LABEL);
+			double sumSquares = 0.0;
+			for (int i = 0; i < numPoints; i++) {
+				point_XYZIRL& p = segment[i];
+				float distance = p.x * normal(0) + p.y * normal(1) + p.z * normal(2);
+				p.h = sign * (distance + negDist); // Signed height above the plane
+				if (distance < currDistThresh && p.l == 0) {
+					p.l = GROUND_LABEL;
+					sumSquares += p.h * p.h;
+					count++;
+				}
+			}
+			plane.residual = count > 0 ? sqrt(sumSquares / count) : 0;
+		}
+	}
+	return count;
+}
+
+// Run the GLA on every segment of the point cloud
+int labelGroundPoints(std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZIRL>& labeledPointCloud, const groundParams& params) {
+	std::vector<segmentStats> stats;
+	return labelGroundPoints(pointCloud, labeledPointCloud, params, stats);
+}
+
+// Run the GLA on every segment of the point cloud, keeping the planes
+int labelGroundPoints(std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZIRL>& labeledPointCloud, const groundParams& params, std::vector<segmentStats>& stats) {
+	GroundSegmenter segmenter(params);
+	segmenter.setSkipZero(false);
+	int count = segmenter.segment(pointCloud, labeledPointCloud);
+	stats = segmenter.getStats();
+	return count;
+}
+
+// Get name of plane status
+const char* getPlaneStatusName(PlaneStatus status) {
+	static const char* NAMES[] = { "fitted", "inherited", "no_seeds", "sparse" };
+	return NAMES[status];
+}
@@ -0,0 +1,334 @@
+#include "groundSegmenter.h"
+#include "polarGrid.h"
+#include "profiler.h"
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Helper functions to sort points
+static bool cmpSegmentX(const point_XYZIRL& p1, const point_XYZIRL& p2) {
+	return p1.x < p2.x;
+}
+static bool cmpSegmentZ(const point_XYZIRL& p1, const point_XYZIRL& p2) {
+	return p1.z < p2.z;
+}
+
+// Num. of threads of the parallel bins and index of the calling one
+static int getMaxThreads() {
+#ifdef _OPENMP
+	return omp_get_max_threads();
+#else
+	return 1;
+#endif
+}
+static int getThreadIndex() {
+#ifdef _OPENMP
+	return omp_get_thread_num();
+#else
+	return 0;
+#endif
+}
+
+GroundSegmenter::GroundSegmenter(const groundParams& groundParameters)
+	: params(groundParameters), skipZero(true), temporal(false), threadScratch(getMaxThreads()) {
+}
+
+// Enable or disable the temporal state
+void GroundSegmenter::setTemporal(bool enabled) {
+	temporal = enabled;
+	reset();
+}
+
+// Forget the planes of the previous frame
+void GroundSegmenter::reset() {
+	for (int s = 0; s < priorPlanes.size(); s++) priorPlanes[s].valid = false;
+}
+
+// Label a point cloud, returning the labels
+int GroundSegmenter::segment(const std::vector<point_XYZIRL>& pointCloud, std::vector<unsigned char>& labels) {
+	int count = labelFrame(pointCloud);
+	StageScope scope(STAGE_REORDER);
+	labels.assign(pointCloud.size(), 0);
+	heights.assign(pointCloud.size(), NAN);
+	for (int i = 0; i < points.size(); i++) {
+		const point_XYZIRL& p = points[i];
+		labels[p.idx] = p.l;
+		heights[p.idx] = p.h;
+	}
+	return count;
+}
+
+// Label a point cloud, returning the labeled points
+int GroundSegmenter::segment(const std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZIRL>& labeledPointCloud) {
+	int count = labelFrame(pointCloud);
+	StageScope scope(STAGE_REORDER);
+	labeledPointCloud.resize(pointCloud.size());
+	heights.assign(pointCloud.size(), NAN);
+	for (int i = 0; i < points.size(); i++) {
+		const point_XYZIRL& p = points[i];
+		point_XYZIRL& labeled = labeledPointCloud[p.idx];
+		labeled = p;
+		labeled.idx = pointCloud[p.idx].idx;
+		heights[p.idx] = p.h;
+	}
+	for (int i = 0; i < emptyPositions.size(); i++) {
+		const point_XYZIRL& p = pointCloud[emptyPositions[i]];
+		point_XYZIRL& empty = labeledPointCloud[emptyPositions[i]];
+		memset(&empty, 0, sizeof(empty));
+		empty.n = p.n;
+		empty.idx = p.idx;
+		empty.h = NAN;
+	}
+	return count;
+}
+
+// Label points read from strided coordinate buffers
+int GroundSegmenter::segment(const float* x, const float* y, const float* z, int stride, int numPoints, unsigned char* labels, float* heights) {
+	StageScope readScope(STAGE_READ);
+	points.clear();
+	emptyPositions.clear();
+	stats.clear();
+	const char* xBytes = (const char*)x;
+	const char* yBytes = (const char*)y;
+	const char* zBytes = (const char*)z;
+	point_XYZIRL p;
+	memset(&p, 0, sizeof(p));
+	p.h = NAN;
+	for (int i = 0; i < numPoints; i++) {
+		memcpy(&p.x, xBytes + (size_t)i * stride, sizeof(float)); // Fields may be unaligned
+		memcpy(&p.y, yBytes + (size_t)i * stride, sizeof(float));
+		memcpy(&p.z, zBytes + (size_t)i * stride, sizeof(float));
+		if (skipZero && p.x == 0 && p.y == 0 && p.z == 0) continue; // Drop zero padding
+		p.idx = i;
+		points.push_back(p);
+	}
+	readScope.stop();
+
+	int count = labelPoints();
+	StageScope scope(STAGE_REORDER);
+	memset(labels, 0, numPoints);
+	if (heights) std::fill(heights, heights + numPoints, NAN);
+	for (int i = 0; i < points.size(); i++) {
+		const point_XYZIRL& p = points[i];
+		labels[p.idx] = p.l;
+		if (heights) heights[p.idx] = p.h;
+	}
+	return count;
+}
+
+// Copy the points to segment and run the GLA on them
+int GroundSegmenter::labelFrame(const std::vector<point_XYZIRL>& pointCloud) {
+	StageScope readScope(STAGE_READ);
+	points.clear();
+	emptyPositions.clear();
+	stats.clear();
+	for (int i = 0; i < pointCloud.size(); i++) {
+		const point_XYZIRL& p = pointCloud[i];
+		if (skipZero && p.x == 0 && p.y == 0 && p.z == 0 && p.r == 0) { // Drop zero padding
+			emptyPositions.push_back(i);
+			continue;
+		}
+		points.push_back(p);
+		points.back().idx = i;
+	}
+	readScope.stop();
+	return labelPoints();
+}
+
+// Run the GLA on the copied points
+int GroundSegmenter::labelPoints() {
+	int count = params.polarGrid ? labelPolar() : labelSegments();
+	if (temporal) keepPlanes();
+	return count;
+}
+
+// Keep the fitted plane of every segment for the next frame
+void GroundSegmenter::keepPlanes() {
+	reset();
+	for (int s = 0; s < stats.size(); s++) {
+		const segmentStats& segment = stats[s];
+		if (segment.id >= priorPlanes.size()) {
+			planeModel invalid;
+			invalid.valid = false;
+			priorPlanes.resize(segment.id + 1, invalid);
+		}
+		if (segment.plane.numSeeds > 0) priorPlanes[segment.id] = segment.plane; // Not inherited
+	}
+}
+
+// Get the initial seeds of a segment sorted on the z-axis
+void GroundSegmenter::getSeeds(const point_XYZIRL* segment, int numPoints, int segmentId, fitScratch& scratch) const {
+	scratch.seeds.clear();
+
+	// Warm start: seeds are the points close to the plane of the previous frame
+	if (temporal && segmentId < priorPlanes.size() && priorPlanes[segmentId].valid) {
+		const planeModel& prior = priorPlanes[segmentId];
+		for (int i = 0; i < numPoints; i++) {
+			const point_XYZIRL& p = segment[i];
+			float distance = prior.normal(0) * p.x + prior.normal(1) * p.y + prior.normal(2) * p.z + prior.negDist;
+			if (fabs(distance) < params.seedThresh) scratch.seeds.push_back(p);
+		}
+		if (scratch.seeds.size() >= params.numLPR) return;
+		scratch.seeds.clear();
+	}
+	extractInitialSeedPoints(segment, numPoints, scratch.seeds, params.numLPR, params.seedThresh, params.method, scratch.values);
+}
+
+// Run the GLA on every segment along the x-axis
+int GroundSegmenter::labelSegments() {
+	typedef std::chrono::steady_clock Clock;
+	{
+		StageScope scope(STAGE_SORT);
+		std::sort(points.begin(), points.end(), cmpSegmentX);
+	}
+
+	// Split the points in equal-count segments and run the algorithm on every segment
+	size_t chunk = ceil((double)points.size() / params.numSegments);
+	fitScratch& scratch = threadScratch[0];
+	int count = 0;
+	for (size_t it = 0; it < points.size(); it += chunk) {
+		TRACE_SCOPE("segment", stats.size());
+		Clock::time_point segmentStart = Clock::now();
+		point_XYZIRL* segment = &points[it];
+		int size = std::min(chunk, points.size() - it);
+
+		// Sort segment on z and skip the mirror reflections at its bottom
+		int numFiltered = 0;
+		{
+			StageScope scope(STAGE_SORT);
+			std::sort(segment, segment + size, cmpSegmentZ);
+			while (numFiltered < size && segment[numFiltered].z < THRESH_ERROR) numFiltered++;
+		}
+
+		// Extract initial seeds
+		{
+			StageScope scope(STAGE_SEED);
+			getSeeds(segment + numFiltered, size - numFiltered, stats.size(), scratch);
+		}
+
+		// Estimate plane and label segment
+		segmentStats segmentStat;
+		segmentStat.id = stats.size();
+		segmentStat.numPoints = size;
+		segmentStat.numGround = 0;
+		if (scratch.seeds.size()) {
+			segmentStat.numGround = fitGroundSegment(segment + numFiltered, size - numFiltered, scratch.seeds, scratch.values, params, segmentStat.plane);
+			segmentStat.status = PLANE_FITTED;
+			count += segmentStat.numGround;
+		} else {
+			segmentStat.plane.valid = false;
+			segmentStat.plane.numSeeds = 0;
+			segmentStat.plane.residual = 0;
+			segmentStat.status = PLANE_NO_SEEDS;
+		}
+		segmentStat.time = std::chrono::duration<double, std::milli>(Clock::now() - segmentStart).count();
+		stats.push_back(segmentStat);
+	}
+	return count;
+}
+
+// Run the GLA on every bin of the polar grid
+int GroundSegmenter::labelPolar() {
+	typedef std::chrono::steady_clock Clock;
+	int numBins = getNumPolarBins();
+	if (threadScratch.size() < getMaxThreads()) threadScratch.resize(getMaxThreads());
+
+	// Assign points to bins in one pass, then scatter them so every bin is contiguous
+	StageScope sortScope(STAGE_SORT);
+	bins.resize(points.size());
+	binStart.assign(numBins + 1, 0);
+	for (int i = 0; i < points.size(); i++) {
+		bins[i] = points[i].z < THRESH_ERROR ? -1 : getPolarBin(points[i]); // Filter mirror reflections
+		if (bins[i] >= 0) binStart[bins[i] + 1]++;
+	}
+	for (int b = 0; b < numBins; b++) binStart[b + 1] += binStart[b];
+	binned.resize(binStart[numBins]);
+	binEnd.assign(binStart.begin(), binStart.end() - 1);
+	for (int i = 0; i < points.size(); i++) {
+		if (bins[i] >= 0) binned[binEnd[bins[i]]++] = points[i];
+	}
+	sortScope.stop();
+
+	// Estimate the plane of every bin with enough points
+	planes.resize(numBins);
+	binGround.assign(numBins, 0);
+	binTime.assign(numBins, 0.0);
+	int count = 0;
+	#pragma omp parallel for schedule(dynamic) reduction(+:count)
+	for (int b = 0; b < numBins; b++) {
+		planes[b].valid = false;
+		planes[b].numSeeds = 0;
+		planes[b].residual = 0;
+		int size = binStart[b + 1] - binStart[b];
+		if (size < POLAR_MIN_BIN_POINTS) continue;
+		TRACE_SCOPE("bin", b);
+		Clock::time_point binStartTime = Clock::now();
+		fitScratch& scratch = threadScratch[getThreadIndex()];
+
+		// Only the lowest points are needed in order to get the LPR
+		point_XYZIRL* segment = &binned[binStart[b]];
+		int numLowest = std::min(params.numLPR, size);
+		StageScope binSortScope(STAGE_SORT);
+		std::partial_sort(segment, segment + numLowest, segment + size, cmpSegmentZ);
+		binSortScope.stop();
+		StageScope seedScope(STAGE_SEED);
+		getSeeds(segment, size, b, scratch);
+		seedScope.stop();
+		binGround[b] = fitGroundSegment(segment, size, scratch.seeds, scratch.values, params, planes[b]);
+		count += binGround[b];
+		binTime[b] = std::chrono::duration<double, std::milli>(Clock::now() - binStartTime).count();
+	}
+
+	// Sparse bins inherit the plane of their neighbours, spreading out until no bin changes
+	StageScope labelScope(STAGE_LABEL);
+	fitted.resize(numBins);
+	for (int b = 0; b < numBins; b++) fitted[b] = planes[b].valid;
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		inherited = planes;
+		for (int b = 0; b < numBins; b++) {
+			if (planes[b].valid) continue;
+			if (inheritPolarPlane(b, planes, inherited[b])) changed = true;
+		}
+		planes.swap(inherited);
+	}
+	for (int b = 0; b < numBins; b++) {
+		if (fitted[b] || !planes[b].valid) continue;
+		const planeModel& plane = planes[b];
+		for (int i = binStart[b]; i < binStart[b + 1]; i++) {
+			point_XYZIRL& p = binned[i];
+			float distance = plane.normal(0) * p.x + plane.normal(1) * p.y + plane.normal(2) * p.z + plane.negDist;
+			p.h = distance;
+			if (distance < params.distThresh && p.l == 0) {
+				p.l = GROUND_LABEL;
+				binGround[b]++;
+				count++;
+			}
+		}
+	}
+	for (int b = 0; b < numBins; b++) {
+		if (binStart[b + 1] == binStart[b]) continue;
+		segmentStats bin;
+		bin.id = b;
+		bin.plane = planes[b];
+		if (fitted[b]) bin.status = PLANE_FITTED;
+		else if (planes[b].valid) bin.status = PLANE_INHERITED;
+		else bin.status = binStart[b + 1] - binStart[b] < POLAR_MIN_BIN_POINTS ? PLANE_SPARSE : PLANE_NO_SEEDS;
+		bin.numPoints = binStart[b + 1] - binStart[b];
+		bin.numGround = binGround[b];
+		bin.time = binTime[b];
+		stats.push_back(bin);
+	}
+	labelScope.stop();
+
+	// Points out of the grid stay as they are, followed by the binned points
+	int numUnbinned = 0;
+	for (int i = 0; i < points.size(); i++) {
+		if (bins[i] < 0) points[numUnbinned++] = points[i];
+	}
+	points.resize(numUnbinned);
+	points.insert(points.end(), binned.begin(), binned.end());
+	return count;
+}
@@ -0,0 +1,71 @@
+#include "groundseg.h"
+#include "groundSegmenter.h"
+#include <limits.h>
+#include <new>
+
+struct gsSegmenter {
+	GroundSegmenter segmenter;
+	gsSegmenter(const groundParams& params) : segmenter(params) {}
+};
+
+// Get ABI version
+int gsGetAbiVersion(void) {
+	return GROUNDSEG_ABI_VERSION;
+}
+
+// Get default parameters
+void gsGetDefaultParams(gsParams* params) {
+	if (params == NULL) return;
+	params->numLPR      = 20;
+	params->numSegments = 1;
+	params->numIters    = 3;
+	params->seedThresh  = 1.2;
+	params->distThresh  = 0.3;
+	params->method      = 1;
+	params->polarGrid   = 0;
+	params->skipZero    = 1;
+	params->temporal    = 0;
+}
+
+// Create segmenter
+gsSegmenter* gsCreate(const gsParams* params) {
+	if (params == NULL || params->numLPR <= 0 || params->numSegments <= 0 || params->numIters < 0) return NULL;
+	groundParams groundParameters;
+	groundParameters.numLPR      = params->numLPR;
+	groundParameters.numSegments = params->numSegments;
+	groundParameters.numIters    = params->numIters;
+	groundParameters.seedThresh  = params->seedThresh;
+	groundParameters.distThresh  = params->distThresh;
+	groundParameters.method      = params->method != 0;
+	groundParameters.polarGrid   = params->polarGrid != 0;
+	try {
+		gsSegmenter* segmenter = new gsSegmenter(groundParameters);
+		segmenter->segmenter.setSkipZero(params->skipZero != 0);
+		segmenter->segmenter.setTemporal(params->temporal != 0);
+		return segmenter;
+	} catch (...) { // No exception crosses the C interface
+		return NULL;
+	}
+}
+
+// Destroy segmenter
+void gsDestroy(gsSegmenter* segmenter) {
+	delete segmenter;
+}
+
+// Label frame
+long gsSegment(gsSegmenter* segmenter, const float* x, const float* y, const float* z, size_t stride,
+               size_t numPoints, unsigned char* labels, float* heights) {
+	if (segmenter == NULL || numPoints > INT_MAX || stride > INT_MAX) return -1;
+	if (numPoints > 0 && (x == NULL || y == NULL || z == NULL || labels == NULL)) return -1;
+	try {
+		return segmenter->segmenter.segment(x, y, z, stride, numPoints, labels, heights);
+	} catch (...) {
+		return -1;
+	}
+}
+
+// Forget previous frame
+void gsReset(gsSegmenter* segmenter) {
+	if (segmenter != NULL) segmenter->segmenter.reset();
+}
@@ -16,13 +16,21 @@
 #include <sstream>
 #include <stdio.h>
 #include <sys/stat.h>
-#include <time.h>
 #include <dirent.h>
 #include <math.h>
+#include <chrono>
 
-#include "groundExtractor.h"
+#include "groundSegmenter.h"
+#include "segmentDaemon.h"
+#include "checkpoint.h"
 #include "includes.h"
 #include "pointCloud.h"
+#include "pcapReader.h"
+#include "velodyneDecoder.h"
+#include "udpSource.h"
+#include "sectorSegmenter.h"
+#include "clustering.h"
+#include "profiler.h"
 
 namespace po = boost::program_options;
 namespace fs = boost::filesystem;
@@ -45,15 +53,203 @@ struct stat sb;
  */
 int getFiles(string path, vector<string>& files);
 
+enum HeightFormat { HEIGHT_NONE, HEIGHT_F16, HEIGHT_I16 };
+enum OutputFormat { OUTPUT_TEXT, OUTPUT_LABELS, OUTPUT_RLE };
+
+// What is saved besides the labels
+struct outputParams {
+	clusterParams clustering;  // Clustering of the non-ground points
+	HeightFormat height;       // Format of the height above ground channel
+	OutputFormat format;       // Whole point cloud as text, or label files only
+	string planesPath;         // File for the segment planes, empty if not saved
+};
+
 /* 
- *	Saves point cloud to text file after computing GLA
+ *	Saves point cloud to text file after computing GLA, in the columns of the input
+ *  (x y z i r l n) followed by the height and cluster id columns if saved
  *  
  *  @params 
  *  	point cloud (vector<Point_XYZIRL>)
+ *      cluster id of every point, saved as an extra column if not empty (vector<int>)
+ *      format of the height column, none if not saved (HeightFormat)
+ * 		file path (string)	 
+ *  @return 1 if successful, 0 if not
+ */
+int saveToFile(const vector<point_XYZIRL>& pointCloud, const vector<int>& clusterIds, HeightFormat height, string filepath);
+
+/* 
+ *	Saves the height and cluster id channels of a point cloud as binary files next 
+ *  to its label file: <path>.height (uint16 half precision or int16 mm per point) and
+ *  <path>.clusters (int32 per point). Channels that are not computed are not saved.
+ *  
+ *  @params 
+ *  	point cloud (vector<Point_XYZIRL>)
+ *      cluster id of every point, empty if not clustered (vector<int>)
+ *      format of the height channel, none if not saved (HeightFormat)
+ * 		file path without extension (string)	 
+ *  @return 1 if successful, 0 if not
+ */
+int saveChannels(const vector<point_XYZIRL>& pointCloud, const vector<int>& clusterIds, HeightFormat height, string filepath);
+
+/* 
+ *	Appends the plane and fit statistics of every segment of a frame to a JSON lines
+ *  file, one line per frame.
+ *  
+ *  @params 
+ *  	statistics of the segments (vector<segmentStats>)
+ *      name of the frame (string)
  * 		file path (string)	 
  *  @return void
  */
-void saveToFile(const vector<point_XYZIRL>& pointCloud, string filepath);
+void saveSegmentStats(const vector<segmentStats>& stats, string frame, string filepath);
+
+/* 
+ *	Rewrites the planes of a resumed run with the last line saved for every frame, so
+ *  frames labeled again are not listed twice, dropping a last line cut short
+ *  
+ *  @params 
+ * 		file path (string)	 
+ *  @return 1 if successful or there is no file, 0 if not
+ */
+int compactSegmentStats(string filepath);
+
+/* 
+ *	Decodes every revolution of a Velodyne pcap capture, runs GLA on it and saves it
+ *  to a text file named after the capture and the revolution number.
+ *  
+ *  @params 
+ *  	path to the pcap file (string)
+ * 		sensor model name (string)
+ *      num. of azimuth columns of the ring grid (int)
+ *      num. of azimuth sectors segmented incrementally, 0 for whole revolutions (int)
+ *      output directory (string)
+ *      ground segmenter of whole revolutions, its parameters are used by the sectors too (GroundSegmenter)
+ *      output parameters (outputParams)
+ *  @return 0 if successfull, 1 if not. 
+ */
+int annotatePcap(string pcapPath, string modelName, int numColumns, int numSectors, string outDir, GroundSegmenter& groundSegmenter, const outputParams& output);
+
+/* 
+ *	Receives Velodyne packets on a UDP port, assembles revolutions and runs GLA on each
+ *  of them as soon as it is completed. Reports the latency from the reception of the 
+ *  packet that completes a revolution to its labels, and the throughput.
+ *  
+ *  @params 
+ *  	UDP port (int)
+ * 		sensor model name (string)
+ *      num. of azimuth columns of the ring grid (int)
+ *      num. of azimuth sectors segmented incrementally, 0 for whole revolutions (int)
+ *      output directory (string)
+ *      ground segmenter of whole revolutions, its parameters are used by the sectors too (GroundSegmenter)
+ *      output parameters (outputParams)
+ *      num. of revolutions to process, 0 for no limit (int)
+ *      seconds without packets before stopping, 0 waits forever (int)
+ *  @return 0 if successfull, 1 if not. 
+ */
+int annotateUdp(int port, string modelName, int numColumns, int numSectors, string outDir, GroundSegmenter& groundSegmenter, const outputParams& output, int numFrames, int idleTime);
+
+/* 
+ *	Labels the next chunk of points completed by the decoder: a whole revolution with
+ *  the GLA, or an azimuth sector with the sector segmenter if one is given.
+ *  
+ *  @params 
+ *  	decoder (VelodyneDecoder)
+ * 		sector segmenter, NULL to label whole revolutions (SectorSegmenter*)
+ *      ground segmenter of whole revolutions (GroundSegmenter)
+ *      label the points still being assembled if nothing is completed (bool)
+ *      reference to labeled chunk (vector<point_XYZIRL>)
+ *      reference to the statistics of the segments of the chunk (vector<segmentStats>)
+ *  @return 1 if a chunk was labeled, 0 if not
+ */
+int labelNextChunk(VelodyneDecoder& decoder, SectorSegmenter* segmenter, GroundSegmenter& groundSegmenter, bool flush, vector<point_XYZIRL>& labeledPointCloud, vector<segmentStats>& stats);
+
+/* 
+ *	Gets the labeled revolution completed by the last chunk, if any.
+ *  
+ *  @params 
+ * 		sector segmenter, NULL when whole revolutions are labeled (SectorSegmenter*)
+ *      reference to last labeled chunk (vector<point_XYZIRL>)
+ *      reference to the statistics of the last labeled chunk (vector<segmentStats>)
+ *      reference to labeled revolution (vector<point_XYZIRL>)
+ *      reference to the statistics of the revolution (vector<segmentStats>)
+ *  @return 1 if a revolution was completed, 0 if not
+ */
+int getRevolution(SectorSegmenter* segmenter, vector<point_XYZIRL>& labeledPointCloud, vector<segmentStats>& chunkStats, 
+                  vector<point_XYZIRL>& revolution, vector<segmentStats>& revolutionStats);
+
+/* 
+ *	Counts the points labeled as ground
+ *  
+ *  @params 
+ *  	point cloud (vector<Point_XYZIRL>)
+ *  @return number of ground points (int)
+ */
+int countGround(const vector<point_XYZIRL>& pointCloud);
+
+/* 
+ *	Puts a labeled point cloud back in input order, clusters its non-ground points and saves it
+ *  
+ *  @params 
+ *  	labeled point cloud (vector<Point_XYZIRL>)
+ *      output parameters (outputParams)
+ * 		file path (string)	 
+ *  @return 1 if the labels and channels were saved, 0 if not
+ */
+int saveLabeled(vector<point_XYZIRL>& labeledPointCloud, const outputParams& output, string filepath);
+
+/* 
+ *	Gets the file saveLabeled saves the labels of a point cloud to
+ *  
+ *  @params 
+ *      output parameters (outputParams)
+ * 		file path (string)	 
+ *  @return path of the text or label file (string)
+ */
+string getLabeledPath(const outputParams& output, string filepath);
+
+/* 
+ *	Saves a labeled revolution as <name>_<frame>.txt, and its planes if requested
+ *  
+ *  @params 
+ *  	labeled point cloud (vector<Point_XYZIRL>)
+ *      statistics of the segments of the revolution (vector<segmentStats>)
+ *      output parameters (outputParams)
+ *      output directory (string)
+ * 		name of the source (string)
+ *      revolution number (int)
+ *  @return 1 if the revolution was saved, 0 if not
+ */
+int saveScan(vector<point_XYZIRL>& labeledPointCloud, const vector<segmentStats>& stats, const outputParams& output, string outDir, string name, int frame);
+
+/* 
+ *	Gets the configuration of the run as a JSON object for the run report
+ *  
+ *  @params 
+ *  	command line options (variables_map)
+ *  @return JSON object (string)
+ */
+string getConfigurationJson(const po::variables_map& opts);
+
+/* 
+ *	Gets the hash of the options the labeled files depend on, so a resumed run can
+ *  tell if they were labeled the same way
+ *  
+ *  @params 
+ *  	command line options (variables_map)
+ *  @return hash (string)
+ */
+string getParamsHash(const po::variables_map& opts);
+
+/* 
+ *	Checks that every file of a checkpoint was labeled with the same options, so
+ *  resuming its run does not overwrite outputs of other options
+ *  
+ *  @params 
+ *  	entry of every input (map<string, checkpointEntry>)
+ *      hash of the options of this run (string)
+ *  @return 1 if all of them were, 0 if not
+ */
+int isLabeledWith(const map<string, checkpointEntry>& checkpoint, string paramsHash);
 
 // GLA - Ground Labeling Algorithm 
 int main(int argc, char* argv[]) {
@@ -69,7 +265,33 @@ int main(int argc, char* argv[]) {
 		("iter",    po::value<int>()->default_value(3), 				   "Num. of plane estimations per segment.")
 		("thseed",  po::value<float>()->default_value(1.2),                "Max. value to determine a seed.")
 		("thdist",  po::value<float>()->default_value(0.3), 			   "Max. value to determine ground distance.")
-		("method",  po::value<bool>()->default_value(true), 			   "Use means or medians to extract seeds.");
+		("method",  po::value<bool>()->default_value(true), 			   "Use means or medians to extract seeds.")
+		("pcap",    po::value<string>()->default_value(""),                "Decode Velodyne packets from a pcap file instead.")
+		("model",   po::value<string>()->default_value("vlp16"),           "Sensor model of the pcap: vlp16, hdl32, hdl64.")
+		("cols",    po::value<int>()->default_value(512),                  "Num. of azimuth columns of the ring grid.")
+		("udp",     po::value<int>()->default_value(0),                    "Receive Velodyne packets on this UDP port instead.")
+		("frames",  po::value<int>()->default_value(0),                    "Num. of revolutions to receive, 0 for no limit.")
+		("idle",    po::value<int>()->default_value(0),                    "Stop after this many seconds without packets.")
+		("sectors", po::value<int>()->default_value(0),                    "Segment packets by azimuth sector as they arrive.")
+		("polar",   po::value<bool>()->default_value(false),               "Segment on a polar grid instead of along the x-axis.")
+		("cluster", po::value<string>()->default_value("none"),            "Cluster non-ground points: none, slr, voxel.")
+		("thrun",   po::value<float>()->default_value(0.5),                "Max. distance between points of a scan line run.")
+		("thmerge", po::value<float>()->default_value(1.0),                "Max. distance to merge runs of adjacent rings.")
+		("tolerance", po::value<float>()->default_value(0.5),              "Max. distance between points of a voxel cluster.")
+		("skipzero", po::value<bool>()->default_value(true),               "Skip points without return (zero padding) of the input files.")
+		("temporal", po::value<bool>()->default_value(false),              "Warm-start the seeds of every segment from the plane of the previous frame.")
+		("daemon",  po::value<string>()->default_value(""),                "Stay resident and label the frames of clients on this Unix socket.")
+		("workers", po::value<int>()->default_value(4),                    "Num. of clients the daemon serves at the same time.")
+		("manifest", po::value<string>()->default_value(""),               "Process the files listed in this file, saving them in --outpath as is.")
+		("shard",   po::value<string>()->default_value("0/1"),             "Process only shard i of N of the manifest (i/N).")
+		("merge",   po::value<bool>()->default_value(false),               "Validate the shards saved in --outpath against --manifest and merge them.")
+		("resume",  po::value<bool>()->default_value(false),               "Continue the last run, skipping the files it labeled with the same options.")
+		("height",  po::value<string>()->default_value("none"),            "Save height above ground: none, f16, i16 (mm).")
+		("planes",  po::value<bool>()->default_value(false),               "Save the plane and fit statistics of every segment.")
+		("format",  po::value<string>()->default_value("text"),            "Output: text (whole cloud), labels (uint8), rle (run-length labels).")
+		("report",  po::value<string>()->default_value(""),                "Save the stage timings of the run as JSON to this file.")
+		("counters", po::value<bool>()->default_value(false),              "Add the hardware counters of every stage to the run report.")
+		("trace",   po::value<string>()->default_value(""),                "Save a Chrome trace of the run to this file (built with GLA_TRACE).");
 	po::variables_map opts;
 	po::store(po::command_line_parser(argc, argv).options(description).run(), opts);
 	try { 
@@ -90,16 +312,130 @@ int main(int argc, char* argv[]) {
 	float seedThresh  = opts["thseed"].as<float>();
 	float distThresh  = opts["thdist"].as<float>();
 	bool method       = opts["method"].as<bool>();
+	string pcapPath   = opts["pcap"].as<string>();
+	string modelName  = opts["model"].as<string>();
+	int numColumns    = opts["cols"].as<int>();
+	int udpPort       = opts["udp"].as<int>();
+	int numFrames     = opts["frames"].as<int>();
+	int idleTime      = opts["idle"].as<int>();
+	int numSectors    = opts["sectors"].as<int>();
+	bool skipZero     = opts["skipzero"].as<bool>();
+	string reportPath = opts["report"].as<string>();
+	string tracePath  = opts["trace"].as<string>();
+#ifndef GLA_TRACE
+	if (!tracePath.empty()) {
+		cerr << "Error: tracing is not compiled in, build with cmake -DGLA_TRACE=ON" << endl;
+		return 1;
+	}
+#endif
+
+	groundParams params;
+	params.numLPR      = numLPR;
+	params.numSegments = numSegments;
+	params.numIters    = numIters;
+	params.seedThresh  = seedThresh;
+	params.distThresh  = distThresh;
+	params.method      = method;
+	params.polarGrid   = opts["polar"].as<bool>();
+	GroundSegmenter segmenter(params);
+	segmenter.setSkipZero(skipZero);
+	segmenter.setTemporal(opts["temporal"].as<bool>());
+
+	outputParams output;
+	output.clustering.numColumns  = numColumns;
+	output.clustering.runThresh   = opts["thrun"].as<float>();
+	output.clustering.mergeThresh = opts["thmerge"].as<float>();
+	output.clustering.tolerance   = opts["tolerance"].as<float>();
+	if (!parseClusterMethod(opts["cluster"].as<string>(), output.clustering.method)) {
+		cerr << "Error: unknown clustering method " << opts["cluster"].as<string>() << endl;
+		return 1;
+	}
+	string heightFormat = opts["height"].as<string>();
+	if (heightFormat == "none") output.height = HEIGHT_NONE;
+	else if (heightFormat == "f16") output.height = HEIGHT_F16;
+	else if (heightFormat == "i16") output.height = HEIGHT_I16;
+	else {
+		cerr << "Error: unknown height format " << heightFormat << endl;
+		return 1;
+	}
+	string outputFormat = opts["format"].as<string>();
+	if (outputFormat == "text") output.format = OUTPUT_TEXT;
+	else if (outputFormat == "labels") output.format = OUTPUT_LABELS;
+	else if (outputFormat == "rle") output.format = OUTPUT_RLE;
+	else {
+		cerr << "Error: unknown output format " << outputFormat << endl;
+		return 1;
+	}
+
+	// Validate and merge the shards of a manifest run
+	string manifestPath = opts["manifest"].as<string>();
+	if (opts["merge"].as<bool>()) {
+		if (manifestPath.empty()) {
+			cerr << "Error: --merge needs the --manifest of the run" << endl;
+			return 1;
+		}
+		mergeSummary summary;
+		int complete = mergeShardManifests(manifestPath, outputPath, summary);
+		cout << "  >> Inputs: " << summary.numInputs << ", done: " << summary.numDone << ", missing: " << summary.numMissing << endl
+		     << "  >> Repeated: " << summary.numDuplicated << ", not in manifest: " << summary.numUnknown
+		     << ", in the wrong shard: " << summary.numMisplaced << ", output file missing: " << summary.numNoFile << endl
+		     << "  >> Points: " << summary.numPoints << ", ground: " << summary.numGround << ", time: " << summary.time / 1000.0 << "s" << endl;
+		if (!complete) {
+			cerr << "Error: the shards in " << outputPath << " do not cover " << manifestPath << endl;
+			return 1;
+		}
+		cout << "  >> Merged manifest saved in: " << (fs::path(outputPath) / "manifest.tsv").string() << endl;
+		return 0;
+	}
+	int shard, numShards;
+	if (!parseShard(opts["shard"].as<string>(), shard, numShards)) {
+		cerr << "Error: shard must be i/N with 0 <= i < N" << endl;
+		return 1;
+	}
+	if (!manifestPath.empty() && (udpPort || !pcapPath.empty() || opts["temporal"].as<bool>())) { // Shards do not see consecutive frames
+		cerr << "Error: a manifest can not be combined with --pcap, --udp or --temporal" << endl;
+		return 1;
+	}
+	bool resume = opts["resume"].as<bool>();
+	if (resume && (udpPort || !pcapPath.empty() || opts["temporal"].as<bool>())) {
+		cerr << "Error: only runs on files without temporal state can be resumed" << endl;
+		return 1;
+	}
+	if (numColumns <= 0 || !(output.clustering.tolerance > 0)) { // Columns divide the rings, the tolerance sizes the voxels
+		cerr << "Error: --cols and --tolerance must be positive" << endl;
+		return 1;
+	}
+
+	// Serve clients until stopped, with no files involved
+	string daemonPath = opts["daemon"].as<string>();
+	if (!daemonPath.empty()) {
+		SegmentDaemon daemon(params, skipZero, opts["temporal"].as<bool>(), opts["workers"].as<int>());
+		if (!daemon.open(daemonPath)) {
+			cerr << "Error: could not listen on " << daemonPath << endl;
+			return 1;
+		}
+		if (!tracePath.empty()) enableTracer(true);
+		cout << "  >> Listening on " << daemonPath << " with " << opts["workers"].as<int>() << " workers" << endl;
+		int numClients = daemon.run();
+		cout << "  >> Stopped after " << numClients << " clients" << endl;
+		if (!tracePath.empty() && !saveTrace(tracePath)) {
+			cerr << "Error: could not save trace " << tracePath << endl;
+			return 1;
+		}
+		return 0;
+	}
 
 	// Start algorithm
 	cout << " --------------------------------------- " << endl	
     	 << "|      Ground Extraction Algorithm      |" << endl
     	 << " --------------------------------------- " << endl
 	     << "[ CONFIGURATION ] " << endl
-	     << "  >> Reading point cloud files from: " << inputPath << endl
+	     << "  >> Reading point cloud files from: " 
+	     << (udpPort ? "UDP port " + boost::lexical_cast<string>(udpPort) : !pcapPath.empty() ? pcapPath
+	         : !manifestPath.empty() ? manifestPath + " (shard " + opts["shard"].as<string>() + ")" : inputPath) << endl
 	     << "  >> Saving annotated files in: " << outputPath << endl
 	     << "  >> Num of iterations: " << numIters << endl
-	     << "  >> Num of segments along the x-axis: " << numSegments << endl
+	     << "  >> Num of segments along the x-axis: " << (params.polarGrid ? "polar grid" : boost::lexical_cast<string>(numSegments)) << endl
 	     << "  >> Num to calculate LPR: " << numLPR << endl
 	     << "  >> Seeds threshold: " << seedThresh << endl
 	     << "  >> Distance threshold: " << distThresh << endl << endl
@@ -107,112 +443,195 @@ int main(int argc, char* argv[]) {
 	
 	// Get all files to be process from the specified directory 
 	vector<string> files; 
-	if (getFiles(inputPath, files)) {
+	string name;
+	if (udpPort) {
+		name = "udp" + boost::lexical_cast<string>(udpPort);
+	} else if (!pcapPath.empty()) {
+		name = fs::path(pcapPath).stem().string(); // Get name of the capture
+	} else if (!manifestPath.empty()) {
+		vector<string> entries;
+		if (!readManifest(manifestPath, entries)) {
+			cerr << "Error: could not read manifest " << manifestPath << endl;
+			return 1;
+		}
+		for (int i = 0; i < entries.size(); i++) {
+			if (getShard(entries[i], numShards) == shard) files.push_back(entries[i]);
+		}
+		cout << "  >> Processing " << files.size() << " of " << entries.size() << " files" << endl;
+	} else if (getFiles(inputPath, files)) {
 		return 1;	
 	} else {
 		cout << "  >> Processing " << files.size() << " files" << endl;
+		fs::path p(inputPath);
+		name = p.parent_path().filename().string(); // Get name of the point cloud directory
 	}
 	
-	// Create output directory
-	int version = 0;
+	// Create output directory: the output path itself for the shards of a manifest,
+	// which every shard shares, else a new version of g_<name>. Resumed runs continue
+	// the last version if it was a resumable run with the same options
+	string paramsHash = getParamsHash(opts);
 	string newDir;
-	fs::path p(inputPath);
-	string name = p.parent_path().filename().string(); // Get name of the point cloud directory
-	do { 
-		newDir = outputPath + "g_" + name + "_" + boost::lexical_cast<string>(++version);
-	} while (stat(newDir.c_str(), &sb) == 0); // Create new version if directory exists
-	cout << "  >> Creating directory " << newDir << endl;
-	mkdir(newDir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH); 
+	string shardManifestPath;
+	string checkpointPath;
+	if (!manifestPath.empty()) {
+		newDir = fs::path(outputPath).string();
+		boost::system::error_code error;
+		fs::create_directories(newDir, error);
+		shardManifestPath = getShardManifestPath(newDir, shard, numShards);
+		checkpointPath = fs::path(shardManifestPath).replace_extension(".checkpoint.tsv").string();
+		map<string, checkpointEntry> previous;
+		if (resume && readCheckpoint(checkpointPath, previous) && !isLabeledWith(previous, paramsHash)) {
+			cerr << "Error: the outputs in " << newDir << " were labeled with other options, resume with those or use another --outpath" << endl;
+			return 1;
+		}
+		remove(shardManifestPath.c_str()); // Left by a previous run of the shard, resumed runs list the files again
+		if (opts["planes"].as<bool>()) {
+			output.planesPath = fs::path(shardManifestPath).replace_extension(".planes.jsonl").string();
+			if (!resume) remove(output.planesPath.c_str());
+		}
+		cout << "  >> Saving shard manifest in " << shardManifestPath << endl;
+	} else {
+		int version = 0;
+		do { 
+			newDir = outputPath + "g_" + name + "_" + boost::lexical_cast<string>(++version);
+		} while (stat(newDir.c_str(), &sb) == 0); // Create new version if directory exists
+		string lastDir = outputPath + "g_" + name + "_" + boost::lexical_cast<string>(version - 1);
+		map<string, checkpointEntry> previous;
+		if (resume && version > 1 && stat((lastDir + "/checkpoint.tsv").c_str(), &sb) == 0
+		    && readCheckpoint(lastDir + "/checkpoint.tsv", previous) && isLabeledWith(previous, paramsHash)) {
+			newDir = lastDir;
+			cout << "  >> Resuming in directory " << newDir << endl;
+		} else {
+			cout << "  >> Creating directory " << newDir << endl;
+			mkdir(newDir.c_str(), S_IRWXU | S_IRWXG | S_IROTH | S_IXOTH); 
+		}
+		checkpointPath = newDir + "/checkpoint.tsv";
+		if (opts["planes"].as<bool>()) output.planesPath = newDir + "/planes.jsonl";
+	}
+
+	// Files labeled by the previous runs, rewritten with a line per file
+	map<string, checkpointEntry> checkpoint;
+	if (resume) {
+		if (!readCheckpoint(checkpointPath, checkpoint) || !saveCheckpoint(checkpointPath, checkpoint)) {
+			cerr << "Error: could not read checkpoint " << checkpointPath << endl;
+			return 1;
+		}
+		cout << "  >> Checkpoint of " << checkpoint.size() << " files in " << checkpointPath << endl;
+		if (!output.planesPath.empty() && !compactSegmentStats(output.planesPath)) {
+			cerr << "Error: could not rewrite planes " << output.planesPath << endl;
+			return 1;
+		}
+	}
 
 	// Annotate ground points
-	clock_t startTime = clock(); 
+	chrono::steady_clock::time_point startTime = chrono::steady_clock::now(); 
+	if (!reportPath.empty()) enableProfiler(true);
+	if (!reportPath.empty() && opts["counters"].as<bool>()) {
+		enablePerfCounters(true);
+		long long counts[NUM_COUNTERS];
+		if (!readPerfCounters(counts)) cout << "  >> Hardware counters not available: " << getPerfCountersError() << endl;
+	}
+	if (!tracePath.empty()) enableTracer(true);
+	if (udpPort) {
+		if (annotateUdp(udpPort, modelName, numColumns, numSectors, newDir, segmenter, output, numFrames, idleTime)) return 1;
+	} else if (!pcapPath.empty()) {
+		if (annotatePcap(pcapPath, modelName, numColumns, numSectors, newDir, segmenter, output)) return 1;
+	}
+	vector<point_XYZIRL> pointCloud;
+	vector<point_XYZIRL> labeledPointCloud;
+	int numSkipped = 0;
 	for (int i = 0; i < files.size(); i++) {	
 
-		vector<point_XYZIRL> pointCloud;
-		vector<point_XYZIRL> labeledPointCloud;
-		vector<point_XYZIRL> filteredPoints;
 		string filename = files[i];
-		string tempPath = inputPath + filename;
+		string tempPath = manifestPath.empty() ? inputPath + filename : getManifestInput(manifestPath, filename);
+		TRACE_SCOPE("frame", i + 1);
+		chrono::steady_clock::time_point fileStart = chrono::steady_clock::now();
+
+		// Skip the file if it is labeled already, unchanged and with the same options
+		checkpointEntry done;
+		if (resume) {
+			if (!getFileHash(tempPath, done.contentHash)) {
+				cout << "ERROR: could not locate file." << endl;
+				return 0;
+			}
+			map<string, checkpointEntry>::const_iterator previous = checkpoint.find(filename);
+			if (previous != checkpoint.end() && previous->second.contentHash == done.contentHash
+			    && previous->second.paramsHash == paramsHash && fs::exists(newDir + "/" + previous->second.frame.output)) {
+				if (!manifestPath.empty() && !saveManifestEntry(shardManifestPath, previous->second.frame)) {
+					cerr << "Error: could not save shard manifest " << shardManifestPath << endl;
+					return 1;
+				}
+				numSkipped++;
+				cout << "  >> File[" << i + 1 << "/" << files.size() << "] - Unchanged, skipped." << endl;
+				continue;
+			}
+		}
 
 	    // Read point cloud 
+		StageScope readScope(STAGE_READ);
+		pointCloud.clear();
 	 	if (!getPointCloud(tempPath, pointCloud)) {
 	 		cout << "ERROR: could not locate file." << endl;
 	 		return 0;
 	 	}
+		readScope.stop();
 
-		// Sort point cloud on x-xis.
-		sortPointCloud(pointCloud, filteredPoints, false, "x");
-
-		// Create subpointclouds and run algorithm on every subpointcloud
-		size_t chunk = ceil((double)pointCloud.size() / numSegments);
-		vector<point_XYZIRL>::iterator start = pointCloud.begin();
-		int count = 0;
-		for(size_t it = 0; it < pointCloud.size(); it += chunk) {
-    		
-    		// Create subpointcloud
-    		vector<point_XYZIRL> sortedPointCloudOnZ(start+it, start+std::min<size_t>(it+chunk, pointCloud.size()));
-    		filteredPoints.clear();
-    		sortPointCloud(sortedPointCloudOnZ, filteredPoints, true, "z");
-
-    		// Extract initial seeds 
-			vector<point_XYZIRL> seeds;
-			extractInitialSeedPoints(sortedPointCloudOnZ, seeds, numLPR, seedThresh, method);
-			
-			// Estimate plane 
-			if (seeds.size()) {
-			 	for (int iter = 0; iter < numIters; iter++) {	
-					//	The linear model to solve is: ax + by +cz + d = 0
-			        //   		where; N = [a b c]     X = [x y z], 
-					//		           d = -(N.transpose * X)
-					MatrixXf xyzM; 
-					MatrixXf normal;
-					if (method) {
-						xyzM  = getSeedMeans(seeds);
-					} else {
-						xyzM = getSeedMedians(seeds);
-					}
-			 		normal = estimatePlaneNormal(seeds, xyzM);
-				    float negDist = -(normal.transpose() * xyzM)(0, 0); // d = -(n.T * X)
-				    float currDistThresh = distThresh - negDist;            // Max ground distance of current model
-			        
-			        // Calculate the distance for each point and compare it with current threshold to 
-			        // determine if it is a ground point or not. 
-			        seeds.clear();           			
-			        if (iter < numIters-1) {  // Continue estimating plane
-				        for (int i = 0; i < sortedPointCloudOnZ.size(); i++) {
-				    		MatrixXf point = convertPointToMatXf(sortedPointCloudOnZ[i]);		
-				   			if (getDistance(point, normal) < currDistThresh) {
-				   				seeds.push_back(sortedPointCloudOnZ[i]);
-				   			}
-						}
-			        } else { // Label final point cloud segment
-			        	for (int i = 0; i < sortedPointCloudOnZ.size(); i++) {
-				    		MatrixXf point = convertPointToMatXf(sortedPointCloudOnZ[i]);		
-				   			if (getDistance(point, normal) < currDistThresh && sortedPointCloudOnZ[i].l == 0) {
-				   				sortedPointCloudOnZ[i].l = GROUND_LABEL; 	
-				   				count++;
-				   			}
-						}	
-						// Add filtered points to the point cloud
-						labeledPointCloud.insert(labeledPointCloud.end(), sortedPointCloudOnZ.begin(), sortedPointCloudOnZ.end());  
-						labeledPointCloud.insert(labeledPointCloud.end(), filteredPoints.begin(), filteredPoints.end());
-			        } 
-				}
-			} else cout << "No seeds extracted." << endl;
+		// Run algorithm on every segment of the point cloud
+		int count = segmenter.segment(pointCloud, labeledPointCloud);
+		string outputName = manifestPath.empty() ? filename : getManifestOutput(filename);
+		string filepath = newDir + "/" + outputName;
+		if (!manifestPath.empty()) fs::create_directories(fs::path(filepath).parent_path());
+		if (!saveLabeled(labeledPointCloud, output, filepath)) { // Not recorded as done
+			cerr << "Error: could not save " << filepath << endl;
+			return 1;
+		}
+		if (!output.planesPath.empty()) {
+			StageScope writeScope(STAGE_WRITE);
+			saveSegmentStats(segmenter.getStats(), filename, output.planesPath);
+		}
+		manifestEntry& entry = done.frame;
+		entry.input     = filename;
+		entry.output    = getLabeledPath(output, outputName);
+		entry.numPoints = labeledPointCloud.size();
+		entry.numGround = count;
+		entry.time      = chrono::duration<double, milli>(chrono::steady_clock::now() - fileStart).count();
+		if (!manifestPath.empty() && !saveManifestEntry(shardManifestPath, entry)) {
+			cerr << "Error: could not save shard manifest " << shardManifestPath << endl;
+			return 1;
 		}
-		clock_t computeTime = clock();
+		done.paramsHash = paramsHash;
+		if (resume && !saveCheckpointEntry(checkpointPath, done)) { // Once the output is saved
+			cerr << "Error: could not save checkpoint " << checkpointPath << endl;
+			return 1;
+		}
+		endProfiledFrame(labeledPointCloud.size());
 		cout << "  >> File[" << i + 1 << "/" << files.size() << "] - "
              << "Ground points found: " << count << " / " << labeledPointCloud.size() << "."
-             << "Time: " << (computeTime - startTime) / double(CLOCKS_PER_SEC) << "s" << endl;
-		sortPointCloud(labeledPointCloud, filteredPoints, false, "n"); // Sort based on the ring
-		string filepath = newDir + "/" + filename;
-		saveToFile(labeledPointCloud, filepath); 
+             << "Time: " << chrono::duration<double>(chrono::steady_clock::now() - fileStart).count() << "s" << endl;
+	}
+	if (resume && !output.planesPath.empty() && !compactSegmentStats(output.planesPath)) { // Drop the lines of files labeled again
+		cerr << "Error: could not rewrite planes " << output.planesPath << endl;
+		return 1;
 	}
-	clock_t finishTime = clock();
+	double totalTime = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
 	cout << endl;
 	cout << "[ DONE ]" << endl
-		 << "  >> Total execution time: " 
-		 << (finishTime - startTime) / double(CLOCKS_PER_SEC) << "s" << endl; 
+		 << "  >> Total execution time: " << totalTime << "s" << endl; 
+	if (resume) cout << "  >> Files skipped, labeled by a previous run: " << numSkipped << endl;
+	if (!reportPath.empty()) {
+		if (!saveRunReport(reportPath, getConfigurationJson(opts))) {
+			cerr << "Error: could not save run report " << reportPath << endl;
+			return 1;
+		}
+		cout << "  >> Run report saved in: " << reportPath << endl;
+	}
+	if (!tracePath.empty()) {
+		if (!saveTrace(tracePath)) {
+			cerr << "Error: could not save trace " << tracePath << endl;
+			return 1;
+		}
+		cout << "  >> Trace saved in: " << tracePath << endl;
+	}
 	return 0;
 }
 
@@ -242,20 +661,352 @@ int getFiles(string path, vector<string>& files) {
 }
 
 // Saves final point cloud to text file 
-void saveToFile(const vector<point_XYZIRL>& pointCloud, string filepath) {
-	int version = 0;
+int saveToFile(const vector<point_XYZIRL>& pointCloud, const vector<int>& clusterIds, HeightFormat height, string filepath) {
+	TRACE_SCOPE("saveToFile", -1);
 	ofstream textfile;
 	 	
-	textfile.open(filepath.c_str(), std::fstream::app);
+	textfile.open(filepath.c_str(), std::fstream::trunc);
+	if (textfile.fail()) return 0;
 	for (int i = 0; i < pointCloud.size(); i++) {
 		textfile << pointCloud[i].x << " " 
 				 << pointCloud[i].y << " " 
 	   		     << pointCloud[i].z << " " 
 				 << pointCloud[i].i << " " 
 	  		     << pointCloud[i].r << " " 
-				 << pointCloud[i].l << endl;
+				 << pointCloud[i].l << " "
+				 << pointCloud[i].n; // Same columns as the input, extra channels after them
+		if (height == HEIGHT_F16) textfile << " " << halfToFloat(floatToHalf(pointCloud[i].h));
+		else if (height == HEIGHT_I16) textfile << " " << quantizeHeight(pointCloud[i].h);
+		if (!clusterIds.empty()) textfile << " " << clusterIds[i];
+		textfile << endl;
 	}
 	textfile.close();
+	return !textfile.fail();
 }
 
 
+
+// Saves height and cluster channels as binary files
+int saveChannels(const vector<point_XYZIRL>& pointCloud, const vector<int>& clusterIds, HeightFormat height, string filepath) {
+	TRACE_SCOPE("saveChannels", -1);
+	if (height != HEIGHT_NONE) {
+		vector<short> heights(pointCloud.size());
+		for (int i = 0; i < pointCloud.size(); i++) {
+			heights[i] = height == HEIGHT_F16 ? floatToHalf(pointCloud[i].h) : quantizeHeight(pointCloud[i].h);
+		}
+		ofstream heightfile((filepath + ".height").c_str(), std::ios::binary | std::ios::trunc);
+		if (!heights.empty()) heightfile.write((const char*)&heights[0], heights.size() * sizeof(short));
+		heightfile.close();
+		if (heightfile.fail()) return 0;
+	}
+	if (!clusterIds.empty()) {
+		ofstream clusterfile((filepath + ".clusters").c_str(), std::ios::binary | std::ios::trunc);
+		clusterfile.write((const char*)&clusterIds[0], clusterIds.size() * sizeof(int));
+		clusterfile.close();
+		if (clusterfile.fail()) return 0;
+	}
+	return 1;
+}
+
+// Appends the segment planes of a frame as a JSON line
+void saveSegmentStats(const vector<segmentStats>& stats, string frame, string filepath) {
+	TRACE_SCOPE("saveSegmentStats", -1);
+	ofstream jsonfile(filepath.c_str(), std::fstream::app);
+	jsonfile << "{\"frame\": " << getJsonString(frame) << ", \"segments\": [";
+	for (int i = 0; i < stats.size(); i++) {
+		const segmentStats& s = stats[i];
+		jsonfile << (i ? ", " : "") << "{\"id\": " << s.id << ", \"valid\": " << (s.plane.valid ? "true" : "false")
+		         << ", \"status\": \"" << getPlaneStatusName(s.status) << "\"";
+		if (s.plane.valid) {
+			jsonfile << ", \"normal\": [" << s.plane.normal(0) << ", " << s.plane.normal(1) << ", " << s.plane.normal(2) << "]"
+			         << ", \"d\": " << s.plane.negDist;
+		}
+		jsonfile << ", \"seeds\": " << s.plane.numSeeds
+		         << ", \"points\": " << s.numPoints
+		         << ", \"ground\": " << s.numGround
+		         << ", \"residual\": " << s.plane.residual
+		         << ", \"ms\": " << s.time << "}";
+	}
+	jsonfile << "]}" << endl;
+}
+
+// Rewrites the segment planes with a line per frame
+int compactSegmentStats(string filepath) {
+	ifstream jsonfile(filepath.c_str());
+	if (jsonfile.fail()) return 1;
+	vector<string> frames;
+	map<string, string> lines;
+	string line;
+	while (getline(jsonfile, line)) {
+		if (jsonfile.eof()) break; // Last line without newline: cut short
+		size_t end = line.find(", \"segments\": ");
+		if (end == string::npos) continue;
+		string frame = line.substr(0, end); // Frame name as saved, escaped
+		if (lines.find(frame) == lines.end()) frames.push_back(frame);
+		lines[frame] = line;
+	}
+	jsonfile.close();
+	string tempPath = filepath + ".tmp";
+	ofstream compacted(tempPath.c_str(), ios::trunc);
+	for (int i = 0; i < frames.size(); i++) compacted << lines[frames[i]] << "\n";
+	compacted.close();
+	if (compacted.fail()) return 0;
+	return rename(tempPath.c_str(), filepath.c_str()) == 0;
+}
+
+// Annotates every revolution of a pcap capture
+int annotatePcap(string pcapPath, string modelName, int numColumns, int numSectors, string outDir, GroundSegmenter& groundSegmenter, const outputParams& output) {
+	VelodyneModel model;
+	if (!parseVelodyneModel(modelName, model)) {
+		cout << "ERROR: unknown sensor model " << modelName << endl;
+		return 1;
+	}
+	PcapReader reader;
+	if (!reader.open(pcapPath, VELODYNE_DATA_PORT)) {
+		cout << "ERROR: could not open capture " << pcapPath << endl;
+		return 1;
+	}
+	VelodyneDecoder decoder(model, numColumns);
+	SectorSegmenter segmenter(numSectors, groundSegmenter.getParams());
+	SectorSegmenter* sectors = numSectors > 0 ? &segmenter : NULL;
+	decoder.setSectors(numSectors);
+	string name = fs::path(pcapPath).stem().string();
+
+	const unsigned char* packet;
+	size_t size;
+	double timestamp;
+	int frame = 0;
+	bool done = false;
+	vector<point_XYZIRL> labeledPointCloud;
+	vector<point_XYZIRL> revolution;
+	vector<segmentStats> chunkStats;
+	vector<segmentStats> revolutionStats;
+	chrono::steady_clock::time_point scanStart = chrono::steady_clock::now();
+	while (!done) {
+		// Decode packets until a revolution or sector is completed or the capture ends
+		StageScope readScope(STAGE_READ);
+		if (reader.nextPacket(packet, size, timestamp)) {
+			decoder.decodePacket(packet, size);
+		} else {
+			done = true;
+		}
+		readScope.stop();
+		while (true) {
+			if (labelNextChunk(decoder, sectors, groundSegmenter, done, labeledPointCloud, chunkStats)) {
+				if (!getRevolution(sectors, labeledPointCloud, chunkStats, revolution, revolutionStats)) continue;
+			} else if (!(done && sectors && sectors->flush(revolution, revolutionStats))) {
+				break; // Wait for more packets, or last revolution of the capture was saved
+			}
+			int count = countGround(revolution);
+			if (!saveScan(revolution, revolutionStats, output, outDir, name, ++frame)) {
+				cerr << "Error: could not save scan " << frame << " in " << outDir << endl;
+				return 1;
+			}
+			chrono::steady_clock::time_point scanEnd = chrono::steady_clock::now();
+			cout << "  >> Scan[" << frame << "] - "
+			     << "Ground points found: " << count << " / " << revolution.size() << "."
+			     << "Time: " << chrono::duration<double>(scanEnd - scanStart).count() << "s" << endl;
+			scanStart = scanEnd;
+		}
+	}
+	return 0;
+}
+
+// Annotates every revolution received on a UDP port
+int annotateUdp(int port, string modelName, int numColumns, int numSectors, string outDir, GroundSegmenter& groundSegmenter, const outputParams& output, int numFrames, int idleTime) {
+	typedef chrono::steady_clock Clock;
+	VelodyneModel model;
+	if (!parseVelodyneModel(modelName, model)) {
+		cout << "ERROR: unknown sensor model " << modelName << endl;
+		return 1;
+	}
+	UdpSource source;
+	if (!source.open(port)) {
+		cout << "ERROR: could not bind UDP port " << port << endl;
+		return 1;
+	}
+	VelodyneDecoder decoder(model, numColumns);
+	SectorSegmenter segmenter(numSectors, groundSegmenter.getParams());
+	SectorSegmenter* sectors = numSectors > 0 ? &segmenter : NULL;
+	decoder.setSectors(numSectors);
+	string name = "udp" + boost::lexical_cast<string>(port);
+
+	int frame = 0;
+	long numPackets = 0;
+	long numPoints = 0;
+	long numChunks = 0;
+	double totalLatency = 0.0;
+	double maxLatency = 0.0;
+	Clock::time_point firstPacket;
+	Clock::time_point lastLabel;
+	vector<point_XYZIRL> labeledPointCloud;
+	vector<point_XYZIRL> revolution;
+	vector<segmentStats> chunkStats;
+	vector<segmentStats> revolutionStats;
+	bool idle = false;
+	while (!idle && (numFrames == 0 || frame < numFrames)) {
+		int received = source.receive(idleTime ? idleTime * 1000 : -1);
+		if (received < 0) {
+			cout << "ERROR (" << errno << "): could not receive packets" << endl;
+			return 1;
+		}
+		idle = received == 0; // Flush the partial revolution or sector below
+		Clock::time_point receiveTime = Clock::now();
+		if (numPackets == 0) firstPacket = receiveTime;
+		numPackets += received;
+
+		StageScope readScope(STAGE_READ);
+		for (int p = 0; p < received; p++) {
+			size_t size;
+			const unsigned char* packet = source.getPacket(p, size);
+			decoder.decodePacket(packet, size);
+		}
+		readScope.stop();
+		double latency = 0.0;
+		while (numFrames == 0 || frame < numFrames) {
+			if (labelNextChunk(decoder, sectors, groundSegmenter, idle, labeledPointCloud, chunkStats)) {
+				// Latency from the packet that completed the revolution or sector to its labels,
+				// chunks flushed after the idle time were not completed by a packet
+				if (!idle) {
+					lastLabel = Clock::now();
+					latency = chrono::duration<double>(lastLabel - receiveTime).count();
+					totalLatency += latency;
+					maxLatency = max(maxLatency, latency);
+					numPoints += labeledPointCloud.size();
+					numChunks++;
+				}
+				if (!getRevolution(sectors, labeledPointCloud, chunkStats, revolution, revolutionStats)) continue;
+			} else if (!(idle && sectors && sectors->flush(revolution, revolutionStats))) {
+				break; // Wait for more packets, or last revolution of the stream was saved
+			}
+			cout << "  >> Scan[" << ++frame << "] - "
+			     << "Ground points found: " << countGround(revolution) << " / " << revolution.size() << "."
+			     << "Latency: " << latency * 1000 << "ms" << endl;
+			if (!saveScan(revolution, revolutionStats, output, outDir, name, frame)) {
+				cerr << "Error: could not save scan " << frame << " in " << outDir << endl;
+				return 1;
+			}
+		}
+	}
+	double elapsed = chrono::duration<double>(lastLabel - firstPacket).count();
+	cout << "  >> Received " << numPackets << " packets, " << frame << " scans" << endl;
+	if (numChunks > 0) {
+		cout << "  >> Packet-to-label latency" << (sectors ? " per sector" : "") << ": mean " 
+		     << totalLatency / numChunks * 1000 << "ms, "
+		     << "max " << maxLatency * 1000 << "ms" << endl
+		     << "  >> Throughput: " << numPoints / elapsed << " points/s, " 
+		     << frame / elapsed << " scans/s" << endl;
+	}
+	return 0;
+}
+
+// Labels the next revolution or sector completed by the decoder
+int labelNextChunk(VelodyneDecoder& decoder, SectorSegmenter* segmenter, GroundSegmenter& groundSegmenter, bool flush, vector<point_XYZIRL>& labeledPointCloud, vector<segmentStats>& stats) {
+	vector<point_XYZIRL> pointCloud;
+	int sector;
+	if (!decoder.getScan(pointCloud, sector)) {
+		sector = decoder.getCurrentSector();
+		if (!flush || !decoder.flush(pointCloud)) return 0;
+	}
+	TRACE_SCOPE("chunk", sector);
+	labeledPointCloud.clear();
+	stats.clear();
+	if (segmenter) {
+		segmenter->segmentSector(pointCloud, sector, labeledPointCloud); // Sector planes are kept by the segmenter
+	} else {
+		groundSegmenter.segment(pointCloud, labeledPointCloud);
+		stats = groundSegmenter.getStats();
+	}
+	return 1;
+}
+
+// Gets the revolution completed by the last labeled chunk
+int getRevolution(SectorSegmenter* segmenter, vector<point_XYZIRL>& labeledPointCloud, vector<segmentStats>& chunkStats, 
+                  vector<point_XYZIRL>& revolution, vector<segmentStats>& revolutionStats) {
+	if (!segmenter) {
+		revolution.swap(labeledPointCloud);
+		revolutionStats.swap(chunkStats);
+		return 1;
+	}
+	return segmenter->getRevolution(revolution, revolutionStats);
+}
+
+// Counts points labeled as ground
+int countGround(const vector<point_XYZIRL>& pointCloud) {
+	int count = 0;
+	for (int i = 0; i < pointCloud.size(); i++) {
+		if (pointCloud[i].l == GROUND_LABEL) count++;
+	}
+	return count;
+}
+
+// Orders, clusters and saves a labeled point cloud
+int saveLabeled(vector<point_XYZIRL>& labeledPointCloud, const outputParams& output, string filepath) {
+	vector<int> clusterIds;
+	StageScope reorderScope(STAGE_REORDER);
+	if (!orderPointCloud(labeledPointCloud)) { // Back to input order
+		cout << "ERROR: repeated input index in " << filepath << endl;
+	}
+	reorderScope.stop();
+	StageScope clusterScope(STAGE_CLUSTER);
+	clusterPoints(labeledPointCloud, output.clustering, clusterIds);
+	clusterScope.stop();
+	StageScope writeScope(STAGE_WRITE);
+	if (output.format == OUTPUT_TEXT) return saveToFile(labeledPointCloud, clusterIds, output.height, filepath);
+	string basepath = fs::path(filepath).replace_extension().string();
+	return saveLabels(labeledPointCloud, getLabeledPath(output, filepath), output.format == OUTPUT_RLE)
+	    && saveChannels(labeledPointCloud, clusterIds, output.height, basepath);
+}
+
+// Gets the file the labels are saved to
+string getLabeledPath(const outputParams& output, string filepath) {
+	if (output.format == OUTPUT_TEXT) return filepath;
+	return fs::path(filepath).replace_extension(output.format == OUTPUT_RLE ? ".rle" : ".labels").string();
+}
+
+// Saves a labeled revolution
+int saveScan(vector<point_XYZIRL>& labeledPointCloud, const vector<segmentStats>& stats, const outputParams& output, string outDir, string name, int frame) {
+	char filename[32];
+	snprintf(filename, sizeof(filename), "_%06d.txt", frame);
+	if (!saveLabeled(labeledPointCloud, output, outDir + "/" + name + filename)) return 0;
+	if (!output.planesPath.empty()) {
+		StageScope writeScope(STAGE_WRITE);
+		saveSegmentStats(stats, name + filename, output.planesPath);
+	}
+	endProfiledFrame(labeledPointCloud.size());
+	return 1;
+}
+
+// Gets the hash of the options the outputs depend on
+string getParamsHash(const po::variables_map& opts) {
+	static const char* IGNORED[] = { "inpath", "outpath", "manifest", "shard", "merge", "resume", "report", "counters", "trace",
+	                                 "daemon", "workers", "pcap", "udp", "frames", "idle" };
+	po::variables_map outputOpts = opts;
+	for (int i = 0; i < sizeof(IGNORED) / sizeof(IGNORED[0]); i++) outputOpts.erase(IGNORED[i]);
+	return getTextHash(getConfigurationJson(outputOpts));
+}
+
+// Checks the options every file of a checkpoint was labeled with
+int isLabeledWith(const map<string, checkpointEntry>& checkpoint, string paramsHash) {
+	for (map<string, checkpointEntry>::const_iterator it = checkpoint.begin(); it != checkpoint.end(); ++it) {
+		if (it->second.paramsHash != paramsHash) return 0;
+	}
+	return 1;
+}
+
+// Gets the options of the run as a JSON object
+string getConfigurationJson(const po::variables_map& opts) {
+	stringstream json;
+	json << "{";
+	for (po::variables_map::const_iterator it = opts.begin(); it != opts.end(); ++it) {
+		json << (it == opts.begin() ? "" : ", ") << getJsonString(it->first) << ": ";
+		const boost::any& value = it->second.value();
+		if (value.type() == typeid(string)) json << getJsonString(boost::any_cast<string>(value));
+		else if (value.type() == typeid(int)) json << boost::any_cast<int>(value);
+		else if (value.type() == typeid(float)) json << boost::any_cast<float>(value);
+		else if (value.type() == typeid(bool)) json << (boost::any_cast<bool>(value) ? "true" : "false");
+		else json << "null";
+	}
+	json << "}";
+	return json.str();
+}
@@ -0,0 +1,95 @@
+/*
+ *  @brief: Writes synthetic Velodyne frames with exact ground truth labels (4 ground,
+ *          1 obstacles, 0 mirror reflections) as text files in the format of the
+ *          SqueezeSeg frames (x y z i r l n), so extractGround, sweepGround and the
+ *          benchmarks can be run without the sample data.
+ *  @file: makeScene.cpp
+ */
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/filesystem.hpp>
+#include <stdio.h>
+
+#include "sceneGenerator.h"
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+using namespace std;
+
+int main(int argc, char* argv[]) {
+
+	// Parse arguments
+	po::options_description description("Usage");
+	description.add_options()
+		("help", "Program usage.")
+		("outpath",   po::value<string>()->default_value("../data/synthetic/"), "Directory of the generated frames.")
+		("model",     po::value<string>()->default_value("hdl64"), "Sensor model: vlp16, hdl32, hdl64.")
+		("cols",      po::value<int>()->default_value(512),     "Num. of azimuth columns (points per ring).")
+		("frames",    po::value<int>()->default_value(10),      "Num. of frames.")
+		("seed",      po::value<unsigned int>()->default_value(1), "Seed of the random generator.")
+		("height",    po::value<float>()->default_value(1.73),  "Height of the sensor above the ground (m).")
+		("slope",     po::value<float>()->default_value(0.0),   "Slope of the ground along x.")
+		("slopey",    po::value<float>()->default_value(0.0),   "Slope of the ground along y.")
+		("break",     po::value<float>()->default_value(0.0),   "x where the slope changes, 0 for a single plane (m).")
+		("breakslope", po::value<float>()->default_value(0.0),  "Slope of the ground along x beyond the break.")
+		("obstacles", po::value<int>()->default_value(20),      "Num. of obstacles per frame.")
+		("noise",     po::value<float>()->default_value(0.02),  "Std. deviation of the range noise (m).")
+		("mirror",    po::value<float>()->default_value(0.001), "Fraction of ground returns that are mirror reflections.")
+		("maxrange",  po::value<float>()->default_value(100.0), "Max. range of the sensor (m).")
+		("padding",   po::value<bool>()->default_value(true),   "Keep rays without return as zero points.");
+	po::variables_map opts;
+	po::store(po::command_line_parser(argc, argv).options(description).run(), opts);
+	if (opts.count("help")) {
+		cout << description;
+		return 1;
+	}
+	try {
+		po::notify(opts);
+	} catch (exception& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+	string outputPath = opts["outpath"].as<string>();
+	int numColumns    = opts["cols"].as<int>();
+	int numFrames     = opts["frames"].as<int>();
+	VelodyneModel model;
+	if (!parseVelodyneModel(opts["model"].as<string>(), model)) {
+		cerr << "Error: unknown sensor model " << opts["model"].as<string>() << endl;
+		return 1;
+	}
+
+	sceneParams params;
+	params.sensorHeight = opts["height"].as<float>();
+	params.slopeX       = opts["slope"].as<float>();
+	params.slopeY       = opts["slopey"].as<float>();
+	params.breakDist    = opts["break"].as<float>();
+	params.breakSlope   = opts["breakslope"].as<float>();
+	params.numObstacles = opts["obstacles"].as<int>();
+	params.rangeNoise   = opts["noise"].as<float>();
+	params.mirrorRatio  = opts["mirror"].as<float>();
+	params.maxRange     = opts["maxrange"].as<float>();
+	params.keepEmpty    = opts["padding"].as<bool>();
+
+	fs::create_directories(outputPath);
+	SceneGenerator scene(model, numColumns, params, opts["seed"].as<unsigned int>());
+	vector<point_XYZIRL> frame;
+	for (int f = 0; f < numFrames; f++) {
+		int count = scene.generate(frame);
+		char filename[32];
+		snprintf(filename, sizeof(filename), "scene_%06d.txt", f + 1);
+		string filepath = (fs::path(outputPath) / filename).string();
+		FILE* textfile = fopen(filepath.c_str(), "w");
+		if (textfile == NULL) {
+			cerr << "Error: could not write " << filepath << endl;
+			return 1;
+		}
+		for (int i = 0; i < frame.size(); i++) {
+			const point_XYZIRL& p = frame[i];
+			fprintf(textfile, "%.3f %.3f %.3f %.2f %.3f %.1f %.1f\n", p.x, p.y, p.z, p.i, p.r, p.l, p.n);
+		}
+		fclose(textfile);
+		cout << "  >> " << filepath << ": " << frame.size() << " points, " << count << " ground" << endl;
+	}
+	return 0;
+}
@@ -0,0 +1,197 @@
+#include "manifest.h"
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <unordered_map>
+#include <unordered_set>
+#include <stdio.h>
+
+#define MANIFEST_HEADER "# input\toutput\tpoints\tground\tms"
+
+namespace fs = boost::filesystem;
+
+// Read input manifest
+int readManifest(std::string path, std::vector<std::string>& entries) {
+	std::ifstream file(path.c_str());
+	if (file.fail()) return 0;
+	std::string line;
+	std::unordered_set<std::string> listed;
+	std::unordered_map<std::string, int> outputs; // Line of the entry saved to every output
+	int number = 0;
+	while (std::getline(file, line)) {
+		number++;
+		boost::trim(line);
+		if (line.empty() || line[0] == '#') continue;
+		std::vector<std::string> parts;
+		boost::split(parts, line, boost::is_any_of("/"));
+		if (line.find('\t') != std::string::npos || std::find(parts.begin(), parts.end(), "..") != parts.end()) {
+			std::cerr << "Error: entry not valid in line " << number << " of " << path << std::endl;
+			return 0;
+		}
+		if (!listed.insert(line).second) {
+			std::cerr << "Error: repeated entry in line " << number << " of " << path << std::endl;
+			return 0;
+		}
+		std::pair<std::unordered_map<std::string, int>::iterator, bool> output = outputs.insert(std::make_pair(getManifestOutput(line), number));
+		if (!output.second) {
+			std::cerr << "Error: entries in lines " << output.first->second << " and " << number << " of " << path
+			          << " have the same output " << output.first->first << std::endl;
+			return 0;
+		}
+		entries.push_back(line);
+	}
+	return 1;
+}
+
+// Get input path of entry
+std::string getManifestInput(std::string manifestPath, std::string entry) {
+	if (entry[0] == '/') return entry;
+	return (fs::path(manifestPath).parent_path() / entry).string();
+}
+
+// Get output path of entry
+std::string getManifestOutput(std::string entry) {
+	std::vector<std::string> parts;
+	boost::split(parts, entry, boost::is_any_of("/"));
+	std::string output;
+	for (int i = 0; i < parts.size(); i++) {
+		if (parts[i].empty() || parts[i] == ".") continue;
+		output += (output.empty() ? "" : "/") + parts[i];
+	}
+	return output;
+}
+
+// Parse shard
+int parseShard(std::string spec, int& shard, int& numShards) {
+	std::vector<std::string> parts;
+	boost::split(parts, spec, boost::is_any_of("/"));
+	if (parts.size() != 2) return 0;
+	try {
+		shard = boost::lexical_cast<int>(parts[0]);
+		numShards = boost::lexical_cast<int>(parts[1]);
+	} catch (boost::bad_lexical_cast&) {
+		return 0;
+	}
+	return numShards > 0 && shard >= 0 && shard < numShards;
+}
+
+// Hash bytes
+unsigned long long getFnvHash(const void* data, size_t size, unsigned long long hash) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	for (size_t i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+// Get shard of entry
+int getShard(const std::string& entry, int numShards) {
+	return getFnvHash(entry.data(), entry.size(), FNV_OFFSET) % numShards;
+}
+
+// Get output manifest of shard
+std::string getShardManifestPath(std::string outDir, int shard, int numShards) {
+	char filename[64];
+	snprintf(filename, sizeof(filename), "shard_%d_of_%d.tsv", shard, numShards);
+	return (fs::path(outDir) / filename).string();
+}
+
+// Append entry to output manifest
+int saveManifestEntry(std::string path, const manifestEntry& entry) {
+	std::ofstream file(path.c_str(), std::fstream::app);
+	if (file.fail()) return 0;
+	if (file.tellp() == 0) file << MANIFEST_HEADER << "\n";
+	file << entry.input << "\t" << entry.output << "\t" << entry.numPoints << "\t"
+	     << entry.numGround << "\t" << entry.time << std::endl;
+	return !file.fail();
+}
+
+// Read output manifest
+int readShardManifest(std::string path, std::vector<manifestEntry>& entries) {
+	std::ifstream file(path.c_str());
+	if (file.fail()) return 0;
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() || line[0] == '#') continue;
+		if (file.eof()) break; // Last line without newline: cut short
+		std::vector<std::string> fields;
+		boost::split(fields, line, boost::is_any_of("\t"));
+		if (fields.size() != 5) continue;
+		manifestEntry entry;
+		entry.input  = fields[0];
+		entry.output = fields[1];
+		try {
+			entry.numPoints = boost::lexical_cast<long>(fields[2]);
+			entry.numGround = boost::lexical_cast<long>(fields[3]);
+			entry.time      = boost::lexical_cast<double>(fields[4]);
+		} catch (boost::bad_lexical_cast&) {
+			continue;
+		}
+		entries.push_back(entry);
+	}
+	return 1;
+}
+
+// Validate and merge output manifests
+int mergeShardManifests(std::string manifestPath, std::string outDir, mergeSummary& summary) {
+	memset(&summary, 0, sizeof(summary));
+	std::vector<std::string> inputs;
+	if (!readManifest(manifestPath, inputs)) return 0;
+	summary.numInputs = inputs.size();
+	std::unordered_map<std::string, int> positions;
+	for (int i = 0; i < inputs.size(); i++) positions[inputs[i]] = i;
+
+	// Gather the outputs of every shard
+	std::vector<int> found(inputs.size(), -1);
+	std::vector<manifestEntry> outputs;
+	int numShards = 0;
+	if (!fs::is_directory(outDir)) return 0;
+	for (fs::directory_iterator it(outDir); it != fs::directory_iterator(); ++it) {
+		int shard, shards;
+		std::string filename = it->path().filename().string();
+		char suffix[8];
+		if (sscanf(filename.c_str(), "shard_%d_of_%d.%7s", &shard, &shards, suffix) != 3 || strcmp(suffix, "tsv") != 0) continue;
+		if (numShards && shards != numShards) {
+			std::cerr << "Error: " << filename << " is not one of " << numShards << " shards" << std::endl;
+			return 0;
+		}
+		numShards = shards;
+		std::vector<manifestEntry> entries;
+		if (!readShardManifest(it->path().string(), entries)) return 0;
+		for (int e = 0; e < entries.size(); e++) {
+			const manifestEntry& entry = entries[e];
+			std::unordered_map<std::string, int>::const_iterator position = positions.find(entry.input);
+			if (position == positions.end()) {
+				summary.numUnknown++;
+			} else if (getShard(entry.input, numShards) != shard) {
+				summary.numMisplaced++;
+			} else if (found[position->second] >= 0) {
+				summary.numDuplicated++;
+			} else if (!fs::exists(fs::path(outDir) / entry.output)) {
+				summary.numNoFile++;
+			} else {
+				found[position->second] = outputs.size();
+				outputs.push_back(entry);
+				summary.numDone++;
+				summary.numPoints += entry.numPoints;
+				summary.numGround += entry.numGround;
+				summary.time += entry.time;
+			}
+		}
+	}
+	summary.numMissing = summary.numInputs - summary.numDone;
+	if (summary.numMissing || summary.numDuplicated || summary.numUnknown || summary.numMisplaced) return 0;
+
+	// Outputs in manifest order
+	std::string mergedPath = (fs::path(outDir) / "manifest.tsv").string();
+	std::ofstream merged(mergedPath.c_str());
+	merged << MANIFEST_HEADER << "\n";
+	for (int i = 0; i < inputs.size(); i++) {
+		const manifestEntry& entry = outputs[found[i]];
+		merged << entry.input << "\t" << entry.output << "\t" << entry.numPoints << "\t"
+		       << entry.numGround << "\t" << entry.time << "\n";
+	}
+	merged.close();
+	return !merged.fail();
+}
@@ -0,0 +1,30 @@
+#include "optionList.h"
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+// Parse a comma separated list of values
+template <typename T>
+static int parseValues(std::string values, std::vector<T>& list) {
+	std::vector<std::string> tokens;
+	boost::split(tokens, values, boost::is_any_of(","));
+	list.clear();
+	try {
+		for (int i = 0; i < tokens.size(); i++) {
+			boost::trim(tokens[i]);
+			if (!tokens[i].empty()) list.push_back(boost::lexical_cast<T>(tokens[i]));
+		}
+	} catch (boost::bad_lexical_cast& e) {
+		return 0;
+	}
+	return !list.empty();
+}
+
+// Parse a comma separated list of integers
+int parseList(std::string values, std::vector<int>& list) {
+	return parseValues(values, list);
+}
+
+// Parse a comma separated list of reals
+int parseList(std::string values, std::vector<float>& list) {
+	return parseValues(values, list);
+}
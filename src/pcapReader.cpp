@@ -0,0 +1,112 @@
+#include "pcapReader.h"
+
+#define PCAP_MAGIC       0xa1b2c3d4
+#define PCAP_MAGIC_NSEC  0xa1b23c4d
+#define LINKTYPE_ETHERNET 1
+#define LINKTYPE_LINUX_SLL 113
+#define PCAP_READ_BUFFER (1 << 20)
+
+// Read big-endian 16 bit value from packet headers
+static unsigned int readBE16(const unsigned char* p) {
+	return (p[0] << 8) | p[1];
+}
+
+PcapReader::PcapReader() : file(NULL), swapped(false), nanosec(false), linkType(0), port(0) {}
+
+PcapReader::~PcapReader() {
+	close();
+}
+
+// Swap the byte order of header fields if needed
+unsigned int PcapReader::toHost(unsigned int value) const {
+	if (!swapped) return value;
+	return ((value & 0xff) << 24) | ((value & 0xff00) << 8) | ((value >> 8) & 0xff00) | (value >> 24);
+}
+
+// Open capture and check the global header
+int PcapReader::open(std::string pathToFile, int udpPort) {
+	close();
+	file = fopen(pathToFile.c_str(), "rb");
+	if (file == NULL) return 0;
+	fileBuffer.resize(PCAP_READ_BUFFER);
+	setvbuf(file, &fileBuffer[0], _IOFBF, fileBuffer.size());
+
+	unsigned int header[6]; // magic, version, thiszone, sigfigs, snaplen, network
+	if (fread(header, sizeof(header), 1, file) != 1) {
+		close();
+		return 0;
+	}
+	swapped = false;
+	if (header[0] == PCAP_MAGIC || header[0] == PCAP_MAGIC_NSEC) {
+		nanosec = header[0] == PCAP_MAGIC_NSEC;
+	} else {
+		swapped = true;
+		if (toHost(header[0]) != PCAP_MAGIC && toHost(header[0]) != PCAP_MAGIC_NSEC) {
+			close();
+			return 0;
+		}
+		nanosec = toHost(header[0]) == PCAP_MAGIC_NSEC;
+	}
+	linkType = toHost(header[5]);
+	if (linkType != LINKTYPE_ETHERNET && linkType != LINKTYPE_LINUX_SLL) {
+		close();
+		return 0;
+	}
+	port = udpPort;
+	return 1;
+}
+
+// Walk the records until a UDP datagram for the selected port is found
+int PcapReader::nextPacket(const unsigned char*& payload, size_t& size, double& timestamp) {
+	if (file == NULL) return 0;
+
+	unsigned int recordHeader[4]; // ts_sec, ts_usec, incl_len, orig_len
+	while (fread(recordHeader, sizeof(recordHeader), 1, file) == 1) {
+		unsigned int length = toHost(recordHeader[2]);
+		record.resize(length);
+		if (length == 0 || fread(&record[0], 1, length, file) != length) return 0;
+		timestamp = toHost(recordHeader[0]) + toHost(recordHeader[1]) * (nanosec ? 1e-9 : 1e-6);
+
+		// Link layer
+		const unsigned char* p = &record[0];
+		const unsigned char* end = p + length;
+		unsigned int etherType;
+		if (linkType == LINKTYPE_ETHERNET) {
+			if (length < 14) continue;
+			etherType = readBE16(p + 12);
+			p += 14;
+			while (etherType == 0x8100 && p + 4 <= end) { // VLAN tags
+				etherType = readBE16(p + 2);
+				p += 4;
+			}
+		} else {
+			if (length < 16) continue;
+			etherType = readBE16(p + 14);
+			p += 16;
+		}
+		if (etherType != 0x0800 || p + 20 > end) continue;
+
+		// IPv4 header, skip fragments
+		unsigned int ipHeader = (p[0] & 0x0f) * 4;
+		if (p[9] != 17 || (readBE16(p + 6) & 0x3fff) != 0 || p + ipHeader + 8 > end) continue;
+		p += ipHeader;
+
+		// UDP header
+		unsigned int dstPort = readBE16(p + 2);
+		unsigned int udpLength = readBE16(p + 4);
+		if (port != 0 && dstPort != (unsigned int)port) continue;
+		if (udpLength < 8 || p + udpLength > end) continue;
+		payload = p + 8;
+		size = udpLength - 8;
+		return 1;
+	}
+	return 0;
+}
+
+// Close capture
+void PcapReader::close() {
+	if (file != NULL) {
+		fclose(file);
+		file = NULL;
+	}
+}
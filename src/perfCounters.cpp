@@ -0,0 +1,100 @@
+#include "perfCounters.h"
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <mutex>
+
+static const char* COUNTER_NAMES[NUM_COUNTERS] = {
+	"cycles", "instructions", "cache_misses", "branch_misses"
+};
+static const unsigned long long COUNTER_CONFIGS[NUM_COUNTERS] = {
+	PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+};
+
+// Counters of one thread, opened as a group so they are read with a single syscall
+struct counterGroup {
+	bool opened;
+	int leader;                    // File descriptor of the first counter opened, -1 if none
+	int fds[NUM_COUNTERS];         // File descriptor of every counter, -1 if not opened
+	int slots[NUM_COUNTERS];       // Position of every counter in the group, -1 if not opened
+	int numOpened;
+	counterGroup() : opened(false), leader(-1), numOpened(0) {}
+	~counterGroup() {
+		if (!opened) return;
+		for (int c = 0; c < NUM_COUNTERS; c++) {
+			if (fds[c] >= 0) close(fds[c]);
+		}
+	}
+};
+
+static bool counting = false;
+static std::mutex errorMutex;
+static std::string openError;
+static thread_local counterGroup group;
+
+// Enable or disable the counters
+void enablePerfCounters(bool enabled) {
+	counting = enabled;
+}
+
+// Check if the counters are enabled
+bool isCounting() {
+	return counting;
+}
+
+// Get name of counter
+const char* getCounterName(PerfCounter counter) {
+	return COUNTER_NAMES[counter];
+}
+
+// Get why the counters are not available
+std::string getPerfCountersError() {
+	std::lock_guard<std::mutex> lock(errorMutex);
+	return openError;
+}
+
+// Open the counters of the calling thread
+static void openCounters(counterGroup& counters) {
+	counters.opened = true;
+	for (int c = 0; c < NUM_COUNTERS; c++) {
+		counters.fds[c] = -1;
+		counters.slots[c] = -1;
+		struct perf_event_attr attr;
+		memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = COUNTER_CONFIGS[c];
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		int fd = syscall(__NR_perf_event_open, &attr, 0, -1, counters.leader, 0);
+		if (fd < 0) {
+			std::lock_guard<std::mutex> lock(errorMutex);
+			if (openError.empty()) openError = std::string(COUNTER_NAMES[c]) + ": " + strerror(errno);
+			continue;
+		}
+		if (counters.leader < 0) counters.leader = fd;
+		counters.fds[c] = fd;
+		counters.slots[c] = counters.numOpened++;
+	}
+}
+
+// Read the counters of the calling thread
+int readPerfCounters(long long values[NUM_COUNTERS]) {
+	if (!group.opened) openCounters(group);
+	for (int c = 0; c < NUM_COUNTERS; c++) values[c] = -1;
+	if (group.leader < 0) return 0;
+
+	// Layout of PERF_FORMAT_GROUP: nr, time enabled, time running, a value per counter
+	unsigned long long data[3 + NUM_COUNTERS];
+	if (read(group.leader, data, sizeof(data)) < (ssize_t)((3 + group.numOpened) * sizeof(unsigned long long))) return 0;
+	if (data[2] == 0) return 0; // Never scheduled on the PMU: unknown, not zero
+	double scale = (double)data[1] / data[2];
+	for (int c = 0; c < NUM_COUNTERS; c++) {
+		if (group.slots[c] >= 0) values[c] = data[3 + group.slots[c]] * scale;
+	}
+	return 1;
+}
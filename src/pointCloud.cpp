@@ -1,4 +1,7 @@
 #include "pointCloud.h"
+#include "tracer.h"
+#include <math.h>
+#include <iterator>
 
 // Override operator>> for types point_XYZIRL
 std::istream& operator>>(std::istream& is, point_XYZIRL& p) {
@@ -7,10 +10,13 @@ std::istream& operator>>(std::istream& is, point_XYZIRL& p) {
 
 // Store point cloud from text file into point cloud vector 
 int getPointCloud(std::string pathToFile, std::vector<point_XYZIRL>& pointCloud) {
+	TRACE_SCOPE("getPointCloud", -1);
 	std::ifstream velodyneFile(pathToFile.c_str());	
 	if (!velodyneFile.fail()) {
 		point_XYZIRL point;
+		point.h = NAN;
 		while (velodyneFile >> point) { // Overload operator>>
+			point.idx = pointCloud.size();
 			pointCloud.push_back(point); 
 		}
 		return 1;	
@@ -61,6 +67,158 @@ void sortPointCloud(std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZ
 	}
 }
 
+// Drop points without return
+int compactPointCloud(std::vector<point_XYZIRL>& pointCloud, std::vector<point_XYZIRL>& emptyPoints) {
+	emptyPoints.clear();
+	size_t kept = 0;
+	for (size_t i = 0; i < pointCloud.size(); i++) {
+		const point_XYZIRL& p = pointCloud[i];
+		if (p.x == 0 && p.y == 0 && p.z == 0 && p.r == 0) {
+			emptyPoints.push_back(p);
+		} else {
+			pointCloud[kept++] = p;
+		}
+	}
+	pointCloud.resize(kept);
+	return emptyPoints.size();
+}
+
+// Add back dropped points
+void restorePointCloud(std::vector<point_XYZIRL>& pointCloud, const std::vector<point_XYZIRL>& emptyPoints) {
+	point_XYZIRL empty;
+	memset(&empty, 0, sizeof(empty));
+	empty.h = NAN;
+	pointCloud.reserve(pointCloud.size() + emptyPoints.size());
+	for (size_t i = 0; i < emptyPoints.size(); i++) {
+		empty.n = emptyPoints[i].n;
+		empty.idx = emptyPoints[i].idx;
+		pointCloud.push_back(empty);
+	}
+}
+
+// Scatter points back to input order
+int orderPointCloud(std::vector<point_XYZIRL>& pointCloud) {
+	int numInput = 0;
+	for (size_t i = 0; i < pointCloud.size(); i++) {
+		if (pointCloud[i].idx < 0) return 0;
+		numInput = std::max(numInput, pointCloud[i].idx + 1);
+	}
+	std::vector<int> positions(numInput, -1);
+	for (size_t i = 0; i < pointCloud.size(); i++) {
+		int& position = positions[pointCloud[i].idx];
+		if (position >= 0) return 0;
+		position = i;
+	}
+	std::vector<point_XYZIRL> ordered;
+	ordered.reserve(pointCloud.size());
+	for (int idx = 0; idx < numInput; idx++) {
+		if (positions[idx] >= 0) ordered.push_back(pointCloud[positions[idx]]);
+	}
+	pointCloud.swap(ordered);
+	return 1;
+}
+
+// Convert float to IEEE half precision (round to nearest even)
+unsigned short floatToHalf(float value) {
+	unsigned int bits;
+	memcpy(&bits, &value, sizeof(bits));
+	unsigned int sign = (bits >> 16) & 0x8000;
+	int exponent = ((bits >> 23) & 0xff) - 127 + 15;
+	unsigned int mantissa = bits & 0x7fffff;
+	if (((bits >> 23) & 0xff) == 0xff) return sign | 0x7c00 | (mantissa ? 0x200 : 0); // Inf / NaN
+	if (exponent >= 31) return sign | 0x7c00;  // Overflow
+	if (exponent <= 0) {                       // Subnormal or zero
+		if (exponent < -10) return sign;
+		mantissa |= 0x800000;
+		int shift = 14 - exponent;
+		unsigned int half = mantissa >> shift;
+		unsigned int rest = mantissa & ((1 << shift) - 1);
+		unsigned int middle = 1 << (shift - 1);
+		if (rest > middle || (rest == middle && (half & 1))) half++;
+		return sign | half;
+	}
+	unsigned int half = sign | (exponent << 10) | (mantissa >> 13);
+	unsigned int rest = mantissa & 0x1fff;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++; // May carry into the exponent
+	return half;
+}
+
+// Convert IEEE half precision to float
+float halfToFloat(unsigned short half) {
+	unsigned int sign = (half & 0x8000) << 16;
+	int exponent = (half >> 10) & 0x1f;
+	unsigned int mantissa = half & 0x3ff;
+	unsigned int bits;
+	if (exponent == 0x1f) {
+		bits = sign | 0x7f800000 | (mantissa << 13);
+	} else if (exponent == 0) {
+		if (mantissa == 0) {
+			bits = sign;
+		} else { // Subnormal, normalize it
+			exponent = 1;
+			while (!(mantissa & 0x400)) {
+				mantissa <<= 1;
+				exponent--;
+			}
+			bits = sign | ((exponent - 15 + 127) << 23) | ((mantissa & 0x3ff) << 13);
+		}
+	} else {
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+	}
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+// Quantize height to millimeters
+short quantizeHeight(float height) {
+	if (isnan(height)) return NO_HEIGHT_I16;
+	float scaled = round(height * HEIGHT_SCALE);
+	return std::max(-32767.0f, std::min(32767.0f, scaled));
+}
+
+// Save labels as bytes, optionally run-length encoded
+int saveLabels(const std::vector<point_XYZIRL>& pointCloud, std::string pathToFile, bool rle) {
+	TRACE_SCOPE("saveLabels", -1);
+	std::vector<unsigned char> buffer;
+	buffer.reserve(rle ? 64 : pointCloud.size());
+	for (size_t i = 0; i < pointCloud.size(); ) {
+		unsigned char label = pointCloud[i].l;
+		if (!rle) {
+			buffer.push_back(label);
+			i++;
+			continue;
+		}
+		size_t run = 1;
+		while (i + run < pointCloud.size() && run < MAX_LABEL_RUN && (unsigned char)pointCloud[i + run].l == label) run++;
+		buffer.push_back(label);
+		buffer.push_back(run & 0xff);
+		buffer.push_back(run >> 8);
+		i += run;
+	}
+	std::ofstream labelFile(pathToFile.c_str(), std::ios::binary | std::ios::trunc);
+	if (buffer.size()) labelFile.write((const char*)&buffer[0], buffer.size());
+	labelFile.close(); // Flushes, so a full disk is reported too
+	return !labelFile.fail();
+}
+
+// Read labels saved by saveLabels
+int getLabels(std::string pathToFile, bool rle, std::vector<unsigned char>& labels) {
+	std::ifstream labelFile(pathToFile.c_str(), std::ios::binary);
+	if (labelFile.fail()) return 0;
+	std::vector<unsigned char> buffer((std::istreambuf_iterator<char>(labelFile)), std::istreambuf_iterator<char>());
+	labels.clear();
+	if (!rle) {
+		labels.swap(buffer);
+		return 1;
+	}
+	if (buffer.size() % 3 != 0) return 0;
+	for (size_t i = 0; i < buffer.size(); i += 3) {
+		labels.insert(labels.end(), buffer[i + 1] | (buffer[i + 2] << 8), buffer[i]);
+	}
+	return 1;
+}
+
 // Convert point from point_XYZIRL to MatrixXf
 Eigen::MatrixXf convertPointToMatXf(point_XYZIRL point) {
 	Eigen::MatrixXf pointXf(1, 3);
@@ -0,0 +1,84 @@
+#include "polarGrid.h"
+#include <math.h>
+
+static const float ZONE_LIMITS[POLAR_ZONES + 1] = { 2.7, 12.3, 22.6, 41.1, 80.0 };
+static const int ZONE_RINGS[POLAR_ZONES]   = { 2, 4, 4, 4 };
+static const int ZONE_SECTORS[POLAR_ZONES] = { 16, 32, 54, 32 };
+
+// Index of the first bin of every zone
+static int zoneOffset(int zone) {
+	int offset = 0;
+	for (int z = 0; z < zone; z++) offset += ZONE_RINGS[z] * ZONE_SECTORS[z];
+	return offset;
+}
+
+// Get number of bins
+int getNumPolarBins() {
+	return zoneOffset(POLAR_ZONES);
+}
+
+// Get bin of a point
+int getPolarBin(const point_XYZIRL& point) {
+	float range = sqrt(point.x * point.x + point.y * point.y);
+	if (range < ZONE_LIMITS[0] || range >= ZONE_LIMITS[POLAR_ZONES]) return -1;
+	int zone = 0;
+	while (range >= ZONE_LIMITS[zone + 1]) zone++;
+
+	float zoneWidth = ZONE_LIMITS[zone + 1] - ZONE_LIMITS[zone];
+	int ring = (range - ZONE_LIMITS[zone]) / zoneWidth * ZONE_RINGS[zone];
+	float azimuth = atan2(point.y, point.x) + PI; // [0, 2pi]
+	int sector = azimuth / (2 * PI) * ZONE_SECTORS[zone];
+	ring = std::min(ring, ZONE_RINGS[zone] - 1);
+	sector = std::min(sector, ZONE_SECTORS[zone] - 1);
+	return zoneOffset(zone) + ring * ZONE_SECTORS[zone] + sector;
+}
+
+// Average the valid planes of the neighbours of a bin (same ring left/right, inner/outer ring)
+static int inheritPlane(int zone, int ring, int sector, const std::vector<planeModel>& planes, planeModel& plane) {
+	int neighbours[4];
+	int numNeighbours = 0;
+	int sectors = ZONE_SECTORS[zone];
+	int offset = zoneOffset(zone);
+	neighbours[numNeighbours++] = offset + ring * sectors + (sector + sectors - 1) % sectors;
+	neighbours[numNeighbours++] = offset + ring * sectors + (sector + 1) % sectors;
+	for (int step = -1; step <= 1; step += 2) { // Adjacent ring, possibly in another zone
+		int z = zone;
+		int r = ring + step;
+		if (r < 0) {
+			if (--z < 0) continue;
+			r = ZONE_RINGS[z] - 1;
+		} else if (r >= ZONE_RINGS[z]) {
+			if (++z >= POLAR_ZONES) continue;
+			r = 0;
+		}
+		int s = sector * ZONE_SECTORS[z] / sectors;
+		neighbours[numNeighbours++] = zoneOffset(z) + r * ZONE_SECTORS[z] + s;
+	}
+
+	int count = 0;
+	plane.normal = Eigen::Vector3f::Zero();
+	plane.negDist = 0;
+	for (int i = 0; i < numNeighbours; i++) {
+		const planeModel& neighbour = planes[neighbours[i]];
+		if (!neighbour.valid) continue;
+		plane.normal += neighbour.normal;
+		plane.negDist += neighbour.negDist;
+		count++;
+	}
+	if (count == 0) return 0;
+	float norm = plane.normal.norm();
+	plane.normal /= norm;
+	plane.negDist /= norm;
+	plane.numSeeds = 0;
+	plane.residual = 0;
+	plane.valid = true;
+	return 1;
+}
+
+// Average the planes of the neighbours of a bin
+int inheritPolarPlane(int bin, const std::vector<planeModel>& planes, planeModel& plane) {
+	int zone = 0;
+	while (bin >= zoneOffset(zone + 1)) zone++;
+	int index = bin - zoneOffset(zone);
+	return inheritPlane(zone, index / ZONE_SECTORS[zone], index % ZONE_SECTORS[zone], planes, plane);
+}
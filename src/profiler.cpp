@@ -0,0 +1,179 @@
+#include "profiler.h"
+#include <atomic>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <stdio.h>
+
+static const char* STAGE_NAMES[NUM_STAGES] = {
+	"read", "sort", "seed", "fit", "label", "reorder", "cluster", "write"
+};
+
+static bool profiling = false;
+static std::chrono::steady_clock::time_point runStart;
+static std::atomic<long long> frameTimes[NUM_STAGES];  // Current frame (ns)
+static std::vector<double> stageSamples[NUM_STAGES];   // Time of every closed frame (ms)
+static std::atomic<long long> stageCounts[NUM_STAGES][NUM_COUNTERS];  // Whole run
+static std::atomic<bool> counterRead[NUM_COUNTERS];    // Counter available on some thread
+static allocStats stageAllocations[NUM_STAGES];       // At the start of the run
+static allocStats frameAllocations;                    // At the start of the current frame
+static std::vector<allocStats> frameAllocSamples;      // Allocations of every closed frame
+static long numFrames = 0;
+static long numPoints = 0;
+
+// Enable or disable the profiler
+void enableProfiler(bool enabled) {
+	profiling = enabled;
+	runStart = std::chrono::steady_clock::now();
+	for (int s = 0; s < NUM_STAGES; s++) {
+		frameTimes[s] = 0;
+		for (int c = 0; c < NUM_COUNTERS; c++) stageCounts[s][c] = 0;
+	}
+	for (int c = 0; c < NUM_COUNTERS; c++) counterRead[c] = false;
+	for (int s = 0; s < NUM_STAGES; s++) getAllocationStats(s, stageAllocations[s]);
+	getAllocationTotals(frameAllocations);
+	resetAllocationPeak();
+}
+
+// Check if the profiler is enabled
+bool isProfiling() {
+	return profiling;
+}
+
+// Get name of stage
+const char* getStageName(PipelineStage stage) {
+	return STAGE_NAMES[stage];
+}
+
+// Add time to a stage of the current frame
+void addStageTime(PipelineStage stage, long long nanoseconds) {
+	frameTimes[stage].fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+// Add hardware counters to a stage
+void addStageCounters(PipelineStage stage, const long long counts[NUM_COUNTERS]) {
+	for (int c = 0; c < NUM_COUNTERS; c++) {
+		if (counts[c] < 0) continue;
+		stageCounts[stage][c].fetch_add(counts[c], std::memory_order_relaxed);
+		if (!counterRead[c].load(std::memory_order_relaxed)) counterRead[c] = true;
+	}
+}
+
+// Close the current frame
+void endProfiledFrame(long framePoints) {
+	if (!profiling) return;
+	for (int s = 0; s < NUM_STAGES; s++) {
+		stageSamples[s].push_back(frameTimes[s].exchange(0) / 1e6);
+	}
+	numFrames++;
+	numPoints += framePoints;
+	if (ALLOC_TRACKED()) {
+		allocStats totals;
+		getAllocationTotals(totals);
+		allocStats frame = totals;
+		frame.allocations -= frameAllocations.allocations;
+		frame.bytes -= frameAllocations.bytes;
+		frameAllocations = totals;
+		frameAllocSamples.push_back(frame);
+		resetAllocationPeak();
+	}
+}
+
+// Value at a percentile of the allocation samples of the frames
+static long long getFramePercentile(long long allocStats::*field, double percentile) {
+	if (frameAllocSamples.empty()) return 0;
+	std::vector<long long> sorted;
+	for (size_t f = 0; f < frameAllocSamples.size(); f++) sorted.push_back(frameAllocSamples[f].*field);
+	std::sort(sorted.begin(), sorted.end());
+	size_t index = percentile / 100.0 * (sorted.size() - 1) + 0.5;
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Value at a percentile of sorted samples
+static double getPercentile(const std::vector<double>& sorted, double percentile) {
+	if (sorted.empty()) return 0;
+	size_t index = percentile / 100.0 * (sorted.size() - 1) + 0.5;
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+// Save the run report as JSON
+int saveRunReport(std::string pathToFile, std::string configuration) {
+	double wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - runStart).count();
+	std::ofstream report(pathToFile.c_str());
+	if (report.fail()) return 0;
+	report << "{\n";
+	if (!configuration.empty()) report << "  \"configuration\": " << configuration << ",\n";
+	if (isCounting()) {
+		std::string error = getPerfCountersError();
+		report << "  \"counters\": {\"available\": [";
+		for (int c = 0, n = 0; c < NUM_COUNTERS; c++) {
+			if (counterRead[c]) report << (n++ ? ", " : "") << "\"" << getCounterName((PerfCounter)c) << "\"";
+		}
+		report << "]" << (error.empty() ? "" : ", \"error\": " + getJsonString(error)) << "},\n";
+	}
+	report << "  \"frames\": " << numFrames << ",\n"
+	       << "  \"points\": " << numPoints << ",\n"
+	       << "  \"wall_s\": " << wallTime << ",\n"
+	       << "  \"points_per_s\": " << (wallTime > 0 ? numPoints / wallTime : 0) << ",\n";
+	if (ALLOC_TRACKED()) {
+		report << "  \"frame_allocations\": {\"p50\": " << getFramePercentile(&allocStats::allocations, 50)
+		       << ", \"max\": " << getFramePercentile(&allocStats::allocations, 100)
+		       << ", \"bytes_p50\": " << getFramePercentile(&allocStats::bytes, 50)
+		       << ", \"bytes_max\": " << getFramePercentile(&allocStats::bytes, 100)
+		       << ", \"peak_bytes_p50\": " << getFramePercentile(&allocStats::peakBytes, 50)
+		       << ", \"peak_bytes_max\": " << getFramePercentile(&allocStats::peakBytes, 100) << "},\n";
+	}
+	report << "  \"stages\": {\n";
+	for (int s = 0; s < NUM_STAGES; s++) {
+		std::vector<double> sorted(stageSamples[s]);
+		std::sort(sorted.begin(), sorted.end());
+		double total = 0;
+		for (size_t i = 0; i < sorted.size(); i++) total += sorted[i];
+		report << "    \"" << STAGE_NAMES[s] << "\": {\"total_ms\": " << total
+		       << ", \"p50_ms\": " << getPercentile(sorted, 50)
+		       << ", \"p90_ms\": " << getPercentile(sorted, 90)
+		       << ", \"p99_ms\": " << getPercentile(sorted, 99)
+		       << ", \"max_ms\": " << (sorted.empty() ? 0 : sorted.back());
+		if (isCounting()) {
+			for (int c = 0; c < NUM_COUNTERS; c++) {
+				report << ", \"" << getCounterName((PerfCounter)c) << "\": ";
+				if (counterRead[c]) report << stageCounts[s][c];
+				else report << "null";
+			}
+			long long cycles = stageCounts[s][COUNTER_CYCLES];
+			report << ", \"ipc\": ";
+			if (counterRead[COUNTER_CYCLES] && counterRead[COUNTER_INSTRUCTIONS] && cycles > 0) report << (double)stageCounts[s][COUNTER_INSTRUCTIONS] / cycles;
+			else report << "null";
+		}
+		if (ALLOC_TRACKED()) {
+			allocStats allocations;
+			getAllocationStats(s, allocations);
+			report << ", \"allocations\": " << allocations.allocations - stageAllocations[s].allocations
+			       << ", \"alloc_bytes\": " << allocations.bytes - stageAllocations[s].bytes
+			       << ", \"peak_bytes\": " << allocations.peakBytes;
+		}
+		report << "}"
+		       << (s + 1 < NUM_STAGES ? ",\n" : "\n");
+	}
+	report << "  }\n}\n";
+	return report.good();
+}
+
+// Quote a JSON string
+std::string getJsonString(const std::string& text) {
+	std::string json = "\"";
+	for (size_t i = 0; i < text.size(); i++) {
+		unsigned char c = text[i];
+		if (c == '"' || c == '\\') {
+			json += '\\';
+			json += c;
+		} else if (c < 0x20) {
+			char escaped[8];
+			snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+			json += escaped;
+		} else {
+			json += c;
+		}
+	}
+	return json + "\"";
+}
@@ -0,0 +1,35 @@
+#include "rangeImage.h"
+
+RangeImage::RangeImage(int columns) : numRings(0), numColumns(columns) {}
+
+// Fill image from the ring grid index of the points
+void RangeImage::build(const std::vector<point_XYZIRL>& pointCloud) {
+	numRings = 0;
+	for (int i = 0; i < pointCloud.size(); i++) {
+		numRings = std::max(numRings, (int)pointCloud[i].n / numColumns + 1);
+	}
+	cells.resize(numRings * numColumns);
+	indices.assign(numRings * numColumns, EMPTY_CELL);
+	overflow.clear();
+	overflowPoints.clear();
+
+	for (int i = 0; i < pointCloud.size(); i++) {
+		int cell = pointCloud[i].n;
+		if (cell >= 0 && indices[cell] == EMPTY_CELL) {
+			indices[cell] = i;
+			cells[cell] = pointCloud[i];
+		} else {
+			overflow.push_back(i);
+			overflowPoints.push_back(pointCloud[i]);
+		}
+	}
+}
+
+// Convert image to flat cloud
+void RangeImage::toPointCloud(std::vector<point_XYZIRL>& pointCloud) const {
+	pointCloud.clear();
+	for (int cell = 0; cell < cells.size(); cell++) {
+		if (indices[cell] != EMPTY_CELL) pointCloud.push_back(cells[cell]);
+	}
+	pointCloud.insert(pointCloud.end(), overflowPoints.begin(), overflowPoints.end());
+}
@@ -0,0 +1,96 @@
+/*
+ *  @brief: Replays the Velodyne packets of a pcap capture over UDP, e.g. to 127.0.0.1,
+ *          so the live ingestion mode of extractGround can be tested and benchmarked
+ *          without a sensor.
+ *  @file: replayPcap.cpp
+ */
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <thread>
+
+#include "includes.h"
+#include "pcapReader.h"
+
+namespace po = boost::program_options;
+using namespace std;
+
+int main(int argc, char* argv[]) {
+
+	// Parse arguments
+	po::options_description description("Usage");
+	description.add_options()
+		("help", "Program usage.")
+		("pcap",  po::value<string>()->required(),              "Path to the pcap capture.")
+		("host",  po::value<string>()->default_value("127.0.0.1"), "Destination address.")
+		("port",  po::value<int>()->default_value(VELODYNE_DATA_PORT), "Destination port.")
+		("speed", po::value<float>()->default_value(1.0),       "Replay speed factor, 0 sends as fast as possible.")
+		("loop",  po::value<int>()->default_value(1),           "Num. of times the capture is replayed.");
+	po::variables_map opts;
+	po::store(po::command_line_parser(argc, argv).options(description).run(), opts);
+	if (opts.count("help")) {
+		cout << description;
+		return 1;
+	}
+	try {
+		po::notify(opts);
+	} catch (exception& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+	string pcapPath = opts["pcap"].as<string>();
+	string host     = opts["host"].as<string>();
+	int port        = opts["port"].as<int>();
+	float speed     = opts["speed"].as<float>();
+	int loops       = opts["loop"].as<int>();
+
+	int sock = socket(AF_INET, SOCK_DGRAM, 0);
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family = AF_INET;
+	address.sin_port   = htons(port);
+	if (sock < 0 || inet_pton(AF_INET, host.c_str(), &address.sin_addr) != 1) {
+		cerr << "Error: could not create socket to " << host << endl;
+		return 1;
+	}
+
+	typedef chrono::steady_clock Clock;
+	long numPackets = 0;
+	Clock::time_point startTime = Clock::now();
+	for (int loop = 0; loop < loops; loop++) {
+		PcapReader reader;
+		if (!reader.open(pcapPath, VELODYNE_DATA_PORT)) {
+			cerr << "Error: could not open capture " << pcapPath << endl;
+			return 1;
+		}
+		const unsigned char* packet;
+		size_t size;
+		double timestamp;
+		double firstTimestamp = -1;
+		Clock::time_point loopStart = Clock::now();
+		while (reader.nextPacket(packet, size, timestamp)) {
+			// Keep the original packet rate scaled by the speed factor
+			if (firstTimestamp < 0) firstTimestamp = timestamp;
+			if (speed > 0) {
+				chrono::duration<double> offset((timestamp - firstTimestamp) / speed);
+				this_thread::sleep_until(loopStart + chrono::duration_cast<Clock::duration>(offset));
+			}
+			if (sendto(sock, packet, size, 0, (struct sockaddr*)&address, sizeof(address)) < 0) {
+				cerr << "Error (" << errno << "): could not send packet" << endl;
+				return 1;
+			}
+			numPackets++;
+		}
+	}
+	double elapsed = chrono::duration<double>(Clock::now() - startTime).count();
+	cout << "  >> Sent " << numPackets << " packets in " << elapsed << "s ("
+	     << (elapsed > 0 ? numPackets / elapsed : 0) << " packets/s)" << endl;
+	close(sock);
+	return 0;
+}
@@ -0,0 +1,137 @@
+#include "sceneGenerator.h"
+#include <math.h>
+
+#define NO_HIT INFINITY
+#define MIN_OBSTACLE_DIST 5.0  // Obstacles are placed at least this far from the sensor (m)
+#define MAX_OBSTACLE_DIST 40.0
+
+SceneGenerator::SceneGenerator(VelodyneModel model, int columns, const sceneParams& sceneParameters, unsigned int seed)
+	: numColumns(columns), params(sceneParameters), generator(seed) {
+	getVelodyneElevations(model, elevations);
+	std::sort(elevations.begin(), elevations.end()); // Ring 0 is the lowest laser
+}
+
+// Height of the piecewise planar ground
+float SceneGenerator::getGroundHeight(float x, float y) const {
+	float z = -params.sensorHeight + params.slopeY * y;
+	if (params.breakDist > 0 && x >= params.breakDist) {
+		return z + params.slopeX * params.breakDist + params.breakSlope * (x - params.breakDist);
+	}
+	return z + params.slopeX * x;
+}
+
+// Place new boxes on the ground around the sensor
+void SceneGenerator::placeObstacles() {
+	std::uniform_real_distribution<float> position(-MAX_OBSTACLE_DIST, MAX_OBSTACLE_DIST);
+	std::uniform_real_distribution<float> size(0.5, 4.5);
+	std::uniform_real_distribution<float> height(0.5, 2.5);
+	obstacles.clear();
+	while (obstacles.size() < params.numObstacles) {
+		float x = position(generator);
+		float y = position(generator);
+		if (sqrt(x * x + y * y) < MIN_OBSTACLE_DIST) continue;
+		float sizeX = size(generator);
+		float sizeY = size(generator);
+		box obstacle;
+		obstacle.min[0] = x - sizeX / 2;
+		obstacle.max[0] = x + sizeX / 2;
+		obstacle.min[1] = y - sizeY / 2;
+		obstacle.max[1] = y + sizeY / 2;
+		obstacle.min[2] = getGroundHeight(x, y) - 0.2; // Sunk a little so sloped ground leaves no gap
+		obstacle.max[2] = obstacle.min[2] + height(generator);
+		obstacles.push_back(obstacle);
+	}
+}
+
+// Distance along a ray from the sensor to the ground
+float SceneGenerator::castGround(const float direction[3]) const {
+	float nearest = NO_HIT;
+	int numPieces = params.breakDist > 0 ? 2 : 1;
+	for (int piece = 0; piece < numPieces; piece++) {
+		// Plane of the piece: z = offset + slope * x + slopeY * y
+		float slope = piece == 0 ? params.slopeX : params.breakSlope;
+		float offset = -params.sensorHeight + (piece == 0 ? 0 : (params.slopeX - params.breakSlope) * params.breakDist);
+		float denominator = direction[2] - slope * direction[0] - params.slopeY * direction[1];
+		if (denominator == 0) continue;
+		float t = offset / denominator;
+		if (t <= 0) continue;
+		float x = t * direction[0];
+		if (numPieces == 2 && (piece == 0) != (x < params.breakDist)) continue;
+		nearest = std::min(nearest, t);
+	}
+	return nearest;
+}
+
+// Distance along a ray from the sensor to the nearest obstacle
+float SceneGenerator::castObstacles(const float direction[3]) const {
+	float nearest = NO_HIT;
+	for (int b = 0; b < obstacles.size(); b++) {
+		float tMin = -NO_HIT;
+		float tMax = NO_HIT;
+		for (int axis = 0; axis < 3; axis++) { // Slab test
+			if (direction[axis] == 0) {
+				if (obstacles[b].min[axis] > 0 || obstacles[b].max[axis] < 0) tMax = -1;
+				continue;
+			}
+			float t1 = obstacles[b].min[axis] / direction[axis];
+			float t2 = obstacles[b].max[axis] / direction[axis];
+			tMin = std::max(tMin, std::min(t1, t2));
+			tMax = std::min(tMax, std::max(t1, t2));
+		}
+		if (tMin > 0 && tMin <= tMax) nearest = std::min(nearest, tMin);
+	}
+	return nearest;
+}
+
+// Cast every ray of a revolution
+int SceneGenerator::generate(std::vector<point_XYZIRL>& frame) {
+	std::normal_distribution<float> noise(0.0, 1.0);
+	std::uniform_real_distribution<float> unit(0.0, 1.0);
+	placeObstacles();
+	frame.clear();
+	frame.reserve(elevations.size() * numColumns);
+
+	int count = 0;
+	for (int ring = 0; ring < elevations.size(); ring++) {
+		float elevation = elevations[ring] * PI / 180.0;
+		for (int column = 0; column < numColumns; column++) {
+			float azimuth = 2 * PI * column / numColumns;
+			float direction[3] = {
+				(float)(cos(elevation) * cos(azimuth)),
+				(float)(-cos(elevation) * sin(azimuth)), // Same orientation as VelodyneDecoder
+				(float)sin(elevation)
+			};
+			float groundDist = castGround(direction);
+			float obstacleDist = castObstacles(direction);
+			float distance = std::min(groundDist, obstacleDist);
+
+			point_XYZIRL point;
+			point.n = ring * numColumns + column;
+			point.h = NAN;
+			if (distance > params.maxRange) { // No return
+				if (!params.keepEmpty) continue;
+				point.x = point.y = point.z = point.i = point.r = point.l = 0;
+				point.idx = frame.size();
+				frame.push_back(point);
+				continue;
+			}
+			bool ground = groundDist <= obstacleDist;
+			if (params.rangeNoise > 0) distance = std::max(0.0f, distance + params.rangeNoise * noise(generator));
+			point.l = ground ? GROUND_LABEL : OBSTACLE_LABEL;
+			point.i = ground ? 0.1 + 0.2 * unit(generator) : 0.3 + 0.6 * unit(generator);
+			if (ground && direction[2] < 0 && unit(generator) < params.mirrorRatio) {
+				// Mirror reflection: the return seems to come from below the ground
+				distance = (THRESH_ERROR - 0.1 - 2 * unit(generator)) / direction[2];
+				point.l = 0;
+			}
+			point.x = distance * direction[0];
+			point.y = distance * direction[1];
+			point.z = distance * direction[2];
+			point.r = distance;
+			point.idx = frame.size();
+			if (point.l == GROUND_LABEL) count++;
+			frame.push_back(point);
+		}
+	}
+	return count;
+}
@@ -0,0 +1,131 @@
+#include "sectorSegmenter.h"
+#include "profiler.h"
+
+SectorSegmenter::SectorSegmenter(int sectors, const groundParams& groundParameters)
+	: numSectors(sectors > 0 ? sectors : 1), params(groundParameters), lastSector(-1), 
+	  numRevolution(0), revolutionReady(false) {
+	planes.resize(numSectors);
+	planeRevolutions.assign(numSectors, -2);
+	for (int s = 0; s < numSectors; s++) planes[s].valid = false;
+}
+
+// Blend the planes of the neighbouring sector and of the previous revolution
+int SectorSegmenter::getPriorPlane(int sectorIndex, planeModel& prior) const {
+	int neighbour = (sectorIndex + numSectors - 1) % numSectors;
+	int count = 0;
+	prior.normal = Eigen::Vector3f::Zero();
+	prior.negDist = 0;
+	if (neighbour != sectorIndex && planes[neighbour].valid && planeRevolutions[neighbour] == numRevolution) {
+		prior.normal += planes[neighbour].normal;
+		prior.negDist += planes[neighbour].negDist;
+		count++;
+	}
+	if (planes[sectorIndex].valid && planeRevolutions[sectorIndex] == numRevolution - 1) {
+		prior.normal += planes[sectorIndex].normal;
+		prior.negDist += planes[sectorIndex].negDist;
+		count++;
+	}
+	if (count == 0) return 0;
+	float norm = prior.normal.norm();
+	prior.normal /= norm;
+	prior.negDist /= norm;
+	prior.valid = true;
+	return 1;
+}
+
+// Label the ground points of a sector
+int SectorSegmenter::segmentSector(std::vector<point_XYZIRL>& sector, int sectorIndex, std::vector<point_XYZIRL>& labeledSector) {
+	// A sector behind the last one starts a new revolution
+	if (sectorIndex <= lastSector) {
+		completed.swap(current);
+		current.clear();
+		completedStats.swap(currentStats);
+		currentStats.clear();
+		revolutionReady = true;
+		numRevolution++;
+	}
+	lastSector = sectorIndex;
+	TRACE_SCOPE("sector", sectorIndex);
+
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point sectorStart = Clock::now();
+	filtered.clear();
+	seeds.clear();
+	labeledSector.clear();
+	StageScope sortScope(STAGE_SORT);
+	sortPointCloud(sector, filtered, true, "z");
+	sortScope.stop();
+
+	// Warm start: seeds are the points close to the prior plane
+	StageScope seedScope(STAGE_SEED);
+	planeModel prior;
+	if (getPriorPlane(sectorIndex, prior)) {
+		for (int i = 0; i < sector.size(); i++) {
+			const point_XYZIRL& p = sector[i];
+			float distance = prior.normal(0) * p.x + prior.normal(1) * p.y + prior.normal(2) * p.z + prior.negDist;
+			if (fabs(distance) < params.seedThresh) seeds.push_back(p);
+		}
+	}
+	if (seeds.size() < params.numLPR) {
+		seeds.clear();
+		extractInitialSeedPoints(sector, seeds, params.numLPR, params.seedThresh, params.method);
+	}
+	seedScope.stop();
+
+	int count = 0;
+	planeModel plane;
+	plane.valid = false;
+	plane.numSeeds = 0;
+	plane.residual = 0;
+	if (seeds.size()) {
+		count = fitGroundSegment(sector, seeds, params, plane);
+		planes[sectorIndex] = plane;
+		planeRevolutions[sectorIndex] = numRevolution;
+	}
+	labeledSector.insert(labeledSector.end(), sector.begin(), sector.end());
+	labeledSector.insert(labeledSector.end(), filtered.begin(), filtered.end());
+	current.insert(current.end(), labeledSector.begin(), labeledSector.end());
+
+	segmentStats stats;
+	stats.id = sectorIndex;
+	stats.plane = plane;
+	stats.status = plane.valid ? PLANE_FITTED : PLANE_NO_SEEDS;
+	stats.numPoints = labeledSector.size();
+	stats.numGround = count;
+	stats.time = std::chrono::duration<double, std::milli>(Clock::now() - sectorStart).count();
+	currentStats.push_back(stats);
+	return count;
+}
+
+// Get last completed revolution
+int SectorSegmenter::getRevolution(std::vector<point_XYZIRL>& revolution) {
+	std::vector<segmentStats> stats;
+	return getRevolution(revolution, stats);
+}
+
+// Get last completed revolution and its sector planes
+int SectorSegmenter::getRevolution(std::vector<point_XYZIRL>& revolution, std::vector<segmentStats>& stats) {
+	if (!revolutionReady) return 0;
+	revolution.swap(completed);
+	completed.clear();
+	stats.swap(completedStats);
+	completedStats.clear();
+	revolutionReady = false;
+	return 1;
+}
+
+// Get revolution in progress
+int SectorSegmenter::flush(std::vector<point_XYZIRL>& revolution) {
+	std::vector<segmentStats> stats;
+	return flush(revolution, stats);
+}
+
+// Get revolution in progress and its sector planes
+int SectorSegmenter::flush(std::vector<point_XYZIRL>& revolution, std::vector<segmentStats>& stats) {
+	revolution.clear();
+	revolution.swap(current);
+	stats.clear();
+	stats.swap(currentStats);
+	lastSector = -1;
+	return !revolution.empty();
+}
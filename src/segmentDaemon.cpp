@@ -0,0 +1,233 @@
+#include "segmentDaemon.h"
+#include "tracer.h"
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <limits.h>
+#include <chrono>
+
+#define SLOT_ALIGNMENT 64
+
+static volatile sig_atomic_t signalled = 0;
+
+// Stop the daemon on SIGINT and SIGTERM
+static void onSignal(int) {
+	signalled = 1;
+}
+
+// Get size of slot
+size_t getDaemonSlotSize(int maxPoints) {
+	size_t size = (size_t)maxPoints * 3 * sizeof(float) + maxPoints;
+	return (size + SLOT_ALIGNMENT - 1) / SLOT_ALIGNMENT * SLOT_ALIGNMENT;
+}
+
+// Get points of slot
+float* getDaemonSlotPoints(void* ring, int slot, int maxPoints) {
+	return (float*)((char*)ring + slot * getDaemonSlotSize(maxPoints));
+}
+
+// Get labels of slot
+unsigned char* getDaemonSlotLabels(void* ring, int slot, int maxPoints) {
+	return (unsigned char*)ring + slot * getDaemonSlotSize(maxPoints) + (size_t)maxPoints * 3 * sizeof(float);
+}
+
+// Send message and descriptor
+int sendDaemonMessage(int sock, const daemonMessage& message, int fd) {
+	struct iovec iov;
+	iov.iov_base = (void*)&message;
+	iov.iov_len  = sizeof(message);
+	struct msghdr header;
+	memset(&header, 0, sizeof(header));
+	header.msg_iov    = &iov;
+	header.msg_iovlen = 1;
+	char control[CMSG_SPACE(sizeof(int))];
+	if (fd >= 0) {
+		memset(control, 0, sizeof(control));
+		header.msg_control    = control;
+		header.msg_controllen = sizeof(control);
+		struct cmsghdr* cmsg = CMSG_FIRSTHDR(&header);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type  = SCM_RIGHTS;
+		cmsg->cmsg_len   = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+	}
+	return sendmsg(sock, &header, MSG_NOSIGNAL) == sizeof(message);
+}
+
+// Receive message and descriptor
+int receiveDaemonMessage(int sock, daemonMessage& message, int* fd) {
+	if (fd) *fd = -1;
+	struct iovec iov;
+	iov.iov_base = &message;
+	iov.iov_len  = sizeof(message);
+	struct msghdr header;
+	memset(&header, 0, sizeof(header));
+	header.msg_iov    = &iov;
+	header.msg_iovlen = 1;
+	char control[CMSG_SPACE(sizeof(int))];
+	header.msg_control    = control;
+	header.msg_controllen = sizeof(control);
+	ssize_t size = recvmsg(sock, &header, MSG_CMSG_CLOEXEC);
+	for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&header); size >= 0 && cmsg != NULL; cmsg = CMSG_NXTHDR(&header, cmsg)) {
+		if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) continue;
+		int received;
+		memcpy(&received, CMSG_DATA(cmsg), sizeof(int));
+		if (fd && *fd < 0) *fd = received;
+		else close(received);
+	}
+	if (size != sizeof(message) || (header.msg_flags & MSG_TRUNC)) {
+		if (fd && *fd >= 0) close(*fd);
+		if (fd) *fd = -1;
+		return 0;
+	}
+	return 1;
+}
+
+SegmentDaemon::SegmentDaemon(const groundParams& params, bool skipZero, bool temporal, int numWorkers)
+	: sock(-1), stopping(false) {
+	for (int i = 0; i < std::max(1, numWorkers); i++) {
+		worker* w = new worker(params);
+		w->segmenter.setSkipZero(skipZero);
+		w->segmenter.setTemporal(temporal);
+		workers.push_back(w);
+	}
+}
+
+SegmentDaemon::~SegmentDaemon() {
+	stop();
+	for (int i = 0; i < threads.size(); i++) threads[i].join();
+	for (int i = 0; i < pending.size(); i++) close(pending[i]);
+	for (int i = 0; i < workers.size(); i++) delete workers[i];
+	if (sock >= 0) {
+		close(sock);
+		unlink(path.c_str());
+	}
+}
+
+// Listen on socket
+int SegmentDaemon::open(std::string socketPath) {
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (socketPath.size() >= sizeof(address.sun_path)) return 0;
+	strcpy(address.sun_path, socketPath.c_str());
+	sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	if (sock < 0) return 0;
+	unlink(socketPath.c_str()); // Left by a daemon that did not exit cleanly
+	if (bind(sock, (struct sockaddr*)&address, sizeof(address)) < 0 || listen(sock, SOMAXCONN) < 0) {
+		close(sock);
+		sock = -1;
+		return 0;
+	}
+	path = socketPath;
+	return 1;
+}
+
+// Accept clients until stopped
+int SegmentDaemon::run() {
+	if (sock < 0) return 0;
+	signal(SIGINT, onSignal);
+	signal(SIGTERM, onSignal);
+	for (int i = 0; i < workers.size(); i++) threads.push_back(std::thread(&SegmentDaemon::work, this, workers[i]));
+
+	int numClients = 0;
+	while (!stopping && !signalled) {
+		struct pollfd fds;
+		fds.fd = sock;
+		fds.events = POLLIN;
+		if (poll(&fds, 1, DAEMON_POLL_MS) <= 0) continue;
+		int client = accept4(sock, NULL, NULL, SOCK_CLOEXEC);
+		if (client < 0) continue;
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.push_back(client);
+		ready.notify_one();
+		numClients++;
+	}
+	stop();
+	return numClients;
+}
+
+// Stop accepting and disconnect clients
+void SegmentDaemon::stop() {
+	std::lock_guard<std::mutex> lock(mutex);
+	stopping = true;
+	for (int i = 0; i < workers.size(); i++) {
+		if (workers[i]->client >= 0) shutdown(workers[i]->client, SHUT_RDWR);
+	}
+	ready.notify_all();
+}
+
+// Serve the clients assigned to a worker
+void SegmentDaemon::work(worker* w) {
+	while (true) {
+		std::unique_lock<std::mutex> lock(mutex);
+		ready.wait(lock, [this] { return stopping || !pending.empty(); });
+		if (stopping) return;
+		int client = pending.front();
+		pending.pop_front();
+		w->client = client;
+		lock.unlock();
+
+		serve(w, client);
+
+		lock.lock();
+		w->client = -1;
+		lock.unlock();
+		close(client);
+	}
+}
+
+// Label the frames of a client until it disconnects
+void SegmentDaemon::serve(worker* w, int client) {
+	typedef std::chrono::steady_clock Clock;
+
+	// Map the ring of the client: it must be sealed against shrinking, or a client
+	// truncating it would crash the daemon on access
+	daemonMessage message;
+	int ringFd = -1;
+	if (!receiveDaemonMessage(client, message, &ringFd)) return;
+	struct stat ringStat;
+	int seals = ringFd >= 0 ? fcntl(ringFd, F_GET_SEALS) : -1; // -1 for files that can not be sealed
+	bool valid = message.type == DAEMON_HELLO && message.version == DAEMON_PROTOCOL_VERSION && ringFd >= 0
+	          && message.numSlots > 0 && message.numSlots <= DAEMON_MAX_SLOTS
+	          && message.maxPoints > 0 && message.maxPoints <= INT_MAX / (3 * sizeof(float))
+	          && fstat(ringFd, &ringStat) == 0 && seals != -1 && (seals & F_SEAL_SHRINK)
+	          && ringStat.st_size >= message.numSlots * getDaemonSlotSize(message.maxPoints);
+	size_t ringSize = valid ? message.numSlots * getDaemonSlotSize(message.maxPoints) : 0;
+	void* ring = valid ? mmap(NULL, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, ringFd, 0) : MAP_FAILED;
+	if (ringFd >= 0) close(ringFd);
+	int numSlots = message.numSlots;
+	int maxPoints = message.maxPoints;
+	memset(&message, 0, sizeof(message));
+	message.version = DAEMON_PROTOCOL_VERSION;
+	message.type = ring == MAP_FAILED ? DAEMON_ERROR : DAEMON_READY;
+	if (!sendDaemonMessage(client, message, -1) || ring == MAP_FAILED) {
+		if (ring != MAP_FAILED) munmap(ring, ringSize);
+		return;
+	}
+
+	// Label every frame submitted, in place
+	w->segmenter.reset();
+	while (receiveDaemonMessage(client, message, NULL)) {
+		if (message.type != DAEMON_SUBMIT || message.slot < 0 || message.slot >= numSlots
+		    || message.numPoints < 0 || message.numPoints > maxPoints) {
+			message.type = DAEMON_ERROR;
+			sendDaemonMessage(client, message, -1);
+			break;
+		}
+		TRACE_SCOPE("frame", message.slot);
+		Clock::time_point start = Clock::now();
+		float* points = getDaemonSlotPoints(ring, message.slot, maxPoints);
+		unsigned char* labels = getDaemonSlotLabels(ring, message.slot, maxPoints);
+		message.numGround = w->segmenter.segment(points, points + 1, points + 2, 3 * sizeof(float), message.numPoints, labels, NULL);
+		message.time = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+		message.type = DAEMON_DONE;
+		if (!sendDaemonMessage(client, message, -1)) break;
+	}
+	munmap(ring, ringSize);
+}
@@ -0,0 +1,177 @@
+/*
+ *  @brief: Parameter sweep of the GLA. Loads every frame of a directory once and labels
+ *          it with every combination of the given parameter values, in parallel, to
+ *          compare the ground precision/recall against the labels of the input (points
+ *          labeled 4 are ground) and the time per frame of each configuration.
+ *          Values are comma separated, e.g. --seg 1,2,4 --thdist 0.2,0.3
+ *  @file: sweepGround.cpp
+ */
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/filesystem.hpp>
+#include <iomanip>
+#include <chrono>
+
+#include "groundExtractor.h"
+#include "groundEvaluation.h"
+#include "optionList.h"
+#include "pointCloud.h"
+
+namespace po = boost::program_options;
+namespace fs = boost::filesystem;
+using namespace std;
+
+// Frame loaded in memory with its ground truth
+struct sweepFrame {
+	vector<point_XYZIRL> pointCloud;
+	vector<unsigned char> truth;
+};
+
+// Result of one configuration
+struct sweepResult {
+	groundParams params;
+	groundScore score;
+	double time;  // Labeling time per frame (ms)
+};
+
+int main(int argc, char* argv[]) {
+
+	// Parse arguments
+	po::options_description description("Usage");
+	description.add_options()
+		("help", "Program usage.")
+		("inpath",   po::value<string>()->default_value("../data/sample/textfiles1/"), "Path to input point clouds.")
+		("lpr",      po::value<string>()->default_value("20"),  "Num. of seeds needed to get the LPR.")
+		("seg",      po::value<string>()->default_value("1"),   "Num. of segments along the x-axis.")
+		("iter",     po::value<string>()->default_value("3"),   "Num. of plane estimations per segment.")
+		("thseed",   po::value<string>()->default_value("1.2"), "Max. value to determine a seed.")
+		("thdist",   po::value<string>()->default_value("0.3"), "Max. value to determine ground distance.")
+		("method",   po::value<string>()->default_value("1"),   "Use means (1) or medians (0) to extract seeds.")
+		("polar",    po::value<string>()->default_value("0"),   "Segment on a polar grid (1) or along the x-axis (0).")
+		("skipzero", po::value<bool>()->default_value(true),    "Skip points without return (zero padding).")
+		("repeat",   po::value<int>()->default_value(1),        "Num. of times every frame is labeled per configuration.");
+	po::variables_map opts;
+	po::store(po::command_line_parser(argc, argv).options(description).run(), opts);
+	if (opts.count("help")) {
+		cout << description;
+		return 1;
+	}
+	try {
+		po::notify(opts);
+	} catch (exception& e) {
+		cerr << "Error: " << e.what() << endl;
+		return 1;
+	}
+	string inputPath = opts["inpath"].as<string>();
+	bool skipZero    = opts["skipzero"].as<bool>();
+	int numRepeats   = max(1, opts["repeat"].as<int>());
+
+	vector<int> numLPRs, numSegments, numIters, methods, polarGrids;
+	vector<float> seedThreshs, distThreshs;
+	if (!parseList(opts["lpr"].as<string>(), numLPRs) || !parseList(opts["seg"].as<string>(), numSegments) ||
+	    !parseList(opts["iter"].as<string>(), numIters) || !parseList(opts["thseed"].as<string>(), seedThreshs) ||
+	    !parseList(opts["thdist"].as<string>(), distThreshs) || !parseList(opts["method"].as<string>(), methods) ||
+	    !parseList(opts["polar"].as<string>(), polarGrids)) {
+		cerr << "Error: parameter values must be comma separated numbers" << endl;
+		return 1;
+	}
+
+	// Parameter grid
+	vector<sweepResult> results;
+	for (int a = 0; a < numLPRs.size(); a++)
+	for (int b = 0; b < numSegments.size(); b++)
+	for (int c = 0; c < numIters.size(); c++)
+	for (int d = 0; d < seedThreshs.size(); d++)
+	for (int e = 0; e < distThreshs.size(); e++)
+	for (int f = 0; f < methods.size(); f++)
+	for (int g = 0; g < polarGrids.size(); g++) {
+		sweepResult result;
+		result.params.numLPR      = numLPRs[a];
+		result.params.numSegments = numSegments[b];
+		result.params.numIters    = numIters[c];
+		result.params.seedThresh  = seedThreshs[d];
+		result.params.distThresh  = distThreshs[e];
+		result.params.method      = methods[f];
+		result.params.polarGrid   = polarGrids[g];
+		memset(&result.score, 0, sizeof(result.score));
+		result.time = 0;
+		results.push_back(result);
+	}
+
+	// Load every frame once
+	if (!fs::is_directory(inputPath)) {
+		cerr << "Error: could not open " << inputPath << endl;
+		return 1;
+	}
+	vector<string> files;
+	for (fs::directory_iterator it(inputPath); it != fs::directory_iterator(); ++it) {
+		if (it->path().extension() == ".txt") files.push_back(it->path().string());
+	}
+	sort(files.begin(), files.end());
+	vector<sweepFrame> frames(files.size());
+	long numPoints = 0;
+	long numGround = 0;
+	for (int f = 0; f < files.size(); f++) {
+		if (!getPointCloud(files[f], frames[f].pointCloud)) {
+			cerr << "Error: could not read " << files[f] << endl;
+			return 1;
+		}
+		numGround += extractGroundTruth(frames[f].pointCloud, frames[f].truth);
+		numPoints += frames[f].truth.size();
+		if (skipZero) {
+			vector<point_XYZIRL> emptyPoints;
+			compactPointCloud(frames[f].pointCloud, emptyPoints);
+		}
+	}
+	cout << "  >> Frames: " << frames.size() << ", points: " << numPoints << ", ground truth points: " << numGround << endl
+	     << "  >> Configurations: " << results.size() << endl;
+	if (frames.empty()) return 1;
+	if (numGround == 0) cout << "  >> No ground truth labels (" << GROUND_LABEL << ") in the input, precision and recall are meaningless" << endl;
+
+	// Evaluate every configuration
+	#pragma omp parallel for schedule(dynamic)
+	for (int r = 0; r < results.size(); r++) {
+		sweepResult& result = results[r];
+		vector<point_XYZIRL> pointCloud;
+		vector<point_XYZIRL> labeledPointCloud;
+		for (int f = 0; f < frames.size(); f++) {
+			for (int rep = 0; rep < numRepeats; rep++) {
+				pointCloud = frames[f].pointCloud;
+				labeledPointCloud.clear();
+				chrono::steady_clock::time_point start = chrono::steady_clock::now();
+				labelGroundPoints(pointCloud, labeledPointCloud, result.params);
+				result.time += chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+			}
+			scoreGroundLabels(labeledPointCloud, frames[f].truth, result.score);
+		}
+		result.time /= (double)frames.size() * numRepeats;
+	}
+
+	// Accuracy vs time table
+	cout << endl << setw(5) << "lpr" << setw(5) << "seg" << setw(5) << "iter" << setw(8) << "thseed"
+	     << setw(8) << "thdist" << setw(7) << "method" << setw(6) << "polar" << setw(11) << "ms/frame"
+	     << setw(11) << "precision" << setw(9) << "recall" << setw(8) << "f1" << endl;
+	int best = 0;
+	double bestF1 = -1;
+	for (int r = 0; r < results.size(); r++) {
+		const sweepResult& result = results[r];
+		double precision = getPrecision(result.score);
+		double recall = getRecall(result.score);
+		double f1 = precision + recall > 0 ? 2 * precision * recall / (precision + recall) : 0;
+		if (f1 > bestF1) {
+			bestF1 = f1;
+			best = r;
+		}
+		cout << fixed << setprecision(3)
+		     << setw(5) << result.params.numLPR << setw(5) << result.params.numSegments << setw(5) << result.params.numIters
+		     << setw(8) << result.params.seedThresh << setw(8) << result.params.distThresh
+		     << setw(7) << (result.params.method ? "means" : "median") << setw(6) << result.params.polarGrid
+		     << setw(11) << result.time << setw(11) << precision << setw(9) << recall << setw(8) << f1 << endl;
+	}
+	const groundParams& params = results[best].params;
+	cout << endl << "  >> Best F1: --lpr " << params.numLPR << " --seg " << params.numSegments << " --iter " << params.numIters
+	     << " --thseed " << params.seedThresh << " --thdist " << params.distThresh << " --method " << params.method
+	     << " --polar " << params.polarGrid << endl;
+	return 0;
+}
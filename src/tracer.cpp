@@ -0,0 +1,91 @@
+#include "tracer.h"
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <iomanip>
+#include <unistd.h>
+
+struct traceEvent {
+	const char* name;
+	long long begin;     // ns since the tracer was enabled
+	long long duration;  // ns
+	int id;
+};
+
+// Events of one thread, written only by that thread
+struct traceBuffer {
+	int thread;
+	std::atomic<unsigned long> head;  // Num. of events ever recorded
+	traceEvent events[TRACE_BUFFER_EVENTS];
+};
+
+static bool tracing = false;
+static std::chrono::steady_clock::time_point traceStart;
+static std::mutex buffersMutex;
+static std::vector<traceBuffer*> buffers;  // Every thread that recorded an event, never freed
+static thread_local traceBuffer* threadBuffer = NULL;
+
+// Enable or disable the tracer
+void enableTracer(bool enabled) {
+	traceStart = std::chrono::steady_clock::now();
+	tracing = enabled;
+}
+
+// Check if the tracer is enabled
+bool isTracing() {
+	return tracing;
+}
+
+// Get the buffer of the calling thread, registering it on its first event
+static traceBuffer* getThreadBuffer() {
+	if (threadBuffer == NULL) {
+		threadBuffer = new traceBuffer;
+		threadBuffer->head = 0;
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		threadBuffer->thread = buffers.size();
+		buffers.push_back(threadBuffer);
+	}
+	return threadBuffer;
+}
+
+// Record an event in the ring buffer of the calling thread
+void addTraceEvent(const char* name, int id, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) {
+	traceBuffer* buffer = getThreadBuffer();
+	unsigned long head = buffer->head.load(std::memory_order_relaxed);
+	traceEvent& event = buffer->events[head % TRACE_BUFFER_EVENTS];
+	event.name = name;
+	event.begin = std::chrono::duration_cast<std::chrono::nanoseconds>(begin - traceStart).count();
+	event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+	event.id = id;
+	buffer->head.store(head + 1, std::memory_order_release);
+}
+
+// Save the events as a Chrome trace
+int saveTrace(std::string pathToFile) {
+	std::ofstream trace(pathToFile.c_str());
+	if (trace.fail()) return 0;
+	int pid = getpid();
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	trace << std::fixed << std::setprecision(3); // Times in us
+	trace << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+	bool first = true;
+	for (size_t b = 0; b < buffers.size(); b++) {
+		const traceBuffer* buffer = buffers[b];
+		trace << (first ? "\n" : ",\n") << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " << pid
+		      << ", \"tid\": " << buffer->thread << ", \"args\": {\"name\": \"thread " << buffer->thread << "\"}}";
+		first = false;
+		unsigned long head = buffer->head.load(std::memory_order_acquire);
+		unsigned long oldest = head > TRACE_BUFFER_EVENTS ? head - TRACE_BUFFER_EVENTS : 0;
+		for (unsigned long e = oldest; e < head; e++) {
+			const traceEvent& event = buffer->events[e % TRACE_BUFFER_EVENTS];
+			trace << ",\n{\"name\": \"" << event.name << "\", \"ph\": \"X\", \"pid\": " << pid
+			      << ", \"tid\": " << buffer->thread
+			      << ", \"ts\": " << event.begin / 1000.0 << ", \"dur\": " << event.duration / 1000.0;
+			if (event.id >= 0) trace << ", \"args\": {\"id\": " << event.id << "}";
+			trace << "}";
+		}
+	}
+	trace << "\n]}\n";
+	return trace.good();
+}
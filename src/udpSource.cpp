@@ -0,0 +1,78 @@
+#include "udpSource.h"
+#include <netinet/in.h>
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+
+UdpSource::UdpSource() : sock(-1) {
+	buffers.resize(UDP_BATCH * UDP_PACKET_SIZE);
+	messages.resize(UDP_BATCH);
+	iovecs.resize(UDP_BATCH);
+	for (int i = 0; i < UDP_BATCH; i++) {
+		iovecs[i].iov_base = &buffers[i * UDP_PACKET_SIZE];
+		iovecs[i].iov_len  = UDP_PACKET_SIZE;
+		memset(&messages[i], 0, sizeof(struct mmsghdr));
+		messages[i].msg_hdr.msg_iov    = &iovecs[i];
+		messages[i].msg_hdr.msg_iovlen = 1;
+	}
+}
+
+UdpSource::~UdpSource() {
+	close();
+}
+
+// Bind socket to the port
+int UdpSource::open(int port) {
+	close();
+	sock = socket(AF_INET, SOCK_DGRAM, 0);
+	if (sock < 0) return 0;
+
+	int reuse = 1;
+	int recvBuffer = UDP_RECV_BUFFER;
+	setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+	setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &recvBuffer, sizeof(recvBuffer));
+
+	struct sockaddr_in address;
+	memset(&address, 0, sizeof(address));
+	address.sin_family      = AF_INET;
+	address.sin_port        = htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	if (bind(sock, (struct sockaddr*)&address, sizeof(address)) < 0) {
+		close();
+		return 0;
+	}
+	return 1;
+}
+
+// Receive a batch of datagrams
+int UdpSource::receive(int timeoutMs) {
+	if (sock < 0) return -1;
+	struct pollfd fds;
+	fds.fd = sock;
+	fds.events = POLLIN;
+	int received = 0;
+	while (received == 0) {
+		int ready = poll(&fds, 1, timeoutMs);
+		if (ready < 0 && errno == EINTR) continue; // Interrupted by a signal
+		if (ready <= 0) return ready;
+		received = recvmmsg(sock, &messages[0], UDP_BATCH, MSG_DONTWAIT, NULL);
+		if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+			received = 0; // Spurious wakeup, nothing queued yet
+		}
+	}
+	return received;
+}
+
+// Get datagram from last batch
+const unsigned char* UdpSource::getPacket(int i, size_t& size) const {
+	size = messages[i].msg_len;
+	return &buffers[i * UDP_PACKET_SIZE];
+}
+
+// Close socket
+void UdpSource::close() {
+	if (sock >= 0) {
+		::close(sock);
+		sock = -1;
+	}
+}
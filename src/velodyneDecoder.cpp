@@ -0,0 +1,184 @@
+#include "velodyneDecoder.h"
+#include <math.h>
+
+#define UPPER_BANK 0xeeff
+#define LOWER_BANK 0xddff
+
+// Vertical angles (degrees) in firing order
+static const float VLP16_ELEVATIONS[16] = {
+	-15, 1, -13, 3, -11, 5, -9, 7, -7, 9, -5, 11, -3, 13, -1, 15
+};
+static const float HDL32_ELEVATIONS[32] = {
+	-30.67, -9.33, -29.33, -8.00, -28.00, -6.67, -26.67, -5.33,
+	-25.33, -4.00, -24.00, -2.67, -22.67, -1.33, -21.33,  0.00,
+	-20.00,  1.33, -18.67,  2.67, -17.33,  4.00, -16.00,  5.33,
+	-14.67,  6.67, -13.33,  8.00, -12.00,  9.33, -10.67, 10.67
+};
+
+// Parse sensor model name
+int parseVelodyneModel(std::string name, VelodyneModel& model) {
+	if (name == "vlp16") model = VLP16;
+	else if (name == "hdl32") model = HDL32;
+	else if (name == "hdl64") model = HDL64;
+	else return 0;
+	return 1;
+}
+
+// Vertical angles of the lasers of a sensor model
+int getVelodyneElevations(VelodyneModel model, std::vector<float>& elevations) {
+	elevations.clear();
+	if (model == VLP16) {
+		elevations.assign(VLP16_ELEVATIONS, VLP16_ELEVATIONS + 16);
+	} else if (model == HDL32) {
+		elevations.assign(HDL32_ELEVATIONS, HDL32_ELEVATIONS + 32);
+	} else { // Nominal HDL-64E angles: upper bank 1/3 deg apart, lower bank 1/2 deg apart
+		for (int i = 0; i < 32; i++) elevations.push_back(2.0 - i / 3.0);
+		for (int i = 0; i < 32; i++) elevations.push_back(-8.83 - i * 0.5);
+	}
+	return elevations.size();
+}
+
+// Build the trigonometric tables of the sensor
+VelodyneDecoder::VelodyneDecoder(VelodyneModel sensorModel, int columns)
+	: model(sensorModel), numColumns(columns), lastAzimuth(-1), numSectors(1), currentSector(0), numDecoded(0) {
+
+	std::vector<float> elevations;
+	numLasers = getVelodyneElevations(model, elevations);
+
+	for (int i = 0; i < numLasers; i++) {
+		sinElevation.push_back(sin(elevations[i] * PI / 180.0));
+		cosElevation.push_back(cos(elevations[i] * PI / 180.0));
+		// Ring is the position of the laser when sorted from the lowest angle
+		int ring = 0;
+		for (int j = 0; j < numLasers; j++) {
+			if (elevations[j] < elevations[i]) ring++;
+		}
+		rings.push_back(ring);
+	}
+
+	sinAzimuth.resize(VELODYNE_AZIMUTH_STEPS);
+	cosAzimuth.resize(VELODYNE_AZIMUTH_STEPS);
+	for (int a = 0; a < VELODYNE_AZIMUTH_STEPS; a++) {
+		double angle = a / 100.0 * PI / 180.0;
+		sinAzimuth[a] = sin(angle);
+		cosAzimuth[a] = cos(angle);
+	}
+}
+
+// Convert one firing of numChannels lasers sharing the same azimuth
+void VelodyneDecoder::addFiring(const unsigned char* channels, int numChannels, int laserBase, int azimuth) {
+
+	// Start a new revolution when the azimuth wraps around, or a new sector
+	int sector = (long)azimuth * numSectors / VELODYNE_AZIMUTH_STEPS;
+	if ((azimuth < lastAzimuth || sector != currentSector) && !current.empty()) {
+		scans.push_back(std::vector<point_XYZIRL>());
+		scans.back().swap(current);
+		scanSectors.push_back(currentSector);
+		current.reserve(scans.back().size());
+	}
+	if (azimuth < lastAzimuth) numDecoded = 0;
+	lastAzimuth = azimuth;
+	currentSector = sector;
+
+	// Unpack the channels first so the conversion loop vectorizes
+	float distance[VELODYNE_CHANNELS];
+	float intensity[VELODYNE_CHANNELS];
+	for (int c = 0; c < numChannels; c++) {
+		const unsigned char* channel = channels + 3 * c;
+		distance[c]  = (channel[0] | (channel[1] << 8)) * VELODYNE_DIST_RESOLUTION;
+		intensity[c] = channel[2] / 255.0f;
+	}
+
+	float x[VELODYNE_CHANNELS];
+	float y[VELODYNE_CHANNELS];
+	float z[VELODYNE_CHANNELS];
+	const float sinA = sinAzimuth[azimuth];
+	const float cosA = cosAzimuth[azimuth];
+	const float* cosE = &cosElevation[laserBase];
+	const float* sinE = &sinElevation[laserBase];
+	for (int c = 0; c < numChannels; c++) {
+		float xy = distance[c] * cosE[c];
+		x[c] = xy * cosA;
+		y[c] = -xy * sinA;
+		z[c] = distance[c] * sinE[c];
+	}
+
+	int column = (long)azimuth * numColumns / VELODYNE_AZIMUTH_STEPS;
+	for (int c = 0; c < numChannels; c++) {
+		if (distance[c] == 0) continue; // No return
+		point_XYZIRL point;
+		point.x = x[c];
+		point.y = y[c];
+		point.z = z[c];
+		point.i = intensity[c];
+		point.r = distance[c];
+		point.l = 0;
+		point.h = NAN;
+		point.n = rings[laserBase + c] * numColumns + column;
+		point.idx = numDecoded++;
+		current.push_back(point);
+	}
+}
+
+// Decode all the blocks of a packet
+int VelodyneDecoder::decodePacket(const unsigned char* packet, size_t size) {
+	if (size != VELODYNE_PACKET_SIZE) return -1;
+
+	const int blockSize = 4 + 3 * VELODYNE_CHANNELS;
+	for (int b = 0; b < VELODYNE_BLOCKS; b++) {
+		const unsigned char* block = packet + b * blockSize;
+		int flag = block[0] | (block[1] << 8);
+		int azimuth = block[2] | (block[3] << 8);
+		if ((flag != UPPER_BANK && flag != LOWER_BANK) || azimuth >= VELODYNE_AZIMUTH_STEPS) return -1;
+
+		if (model == VLP16) {
+			// Two firing sequences per block, the second one half way to the next block
+			int next;
+			if (b + 1 < VELODYNE_BLOCKS) {
+				const unsigned char* nextBlock = block + blockSize;
+				next = nextBlock[2] | (nextBlock[3] << 8);
+			} else {
+				const unsigned char* prevBlock = block - blockSize;
+				next = 2 * azimuth - (prevBlock[2] | (prevBlock[3] << 8));
+			}
+			int gap = (next - azimuth + VELODYNE_AZIMUTH_STEPS) % VELODYNE_AZIMUTH_STEPS;
+			addFiring(block + 4, 16, 0, azimuth);
+			addFiring(block + 4 + 3 * 16, 16, 0, (azimuth + gap / 2) % VELODYNE_AZIMUTH_STEPS);
+		} else if (model == HDL32) {
+			addFiring(block + 4, 32, 0, azimuth);
+		} else {
+			addFiring(block + 4, 32, flag == LOWER_BANK ? 32 : 0, azimuth);
+		}
+	}
+	return scans.size();
+}
+
+// Return oldest completed revolution
+int VelodyneDecoder::getScan(std::vector<point_XYZIRL>& scan) {
+	int sector;
+	return getScan(scan, sector);
+}
+
+// Return oldest completed sector
+int VelodyneDecoder::getScan(std::vector<point_XYZIRL>& scan, int& sector) {
+	if (scans.empty()) return 0;
+	scan.swap(scans.front());
+	sector = scanSectors.front();
+	scans.pop_front();
+	scanSectors.pop_front();
+	return 1;
+}
+
+// Set num. of sectors per revolution
+void VelodyneDecoder::setSectors(int sectors) {
+	numSectors = sectors > 0 ? sectors : 1;
+}
+
+// Return the revolution being assembled
+int VelodyneDecoder::flush(std::vector<point_XYZIRL>& scan) {
+	scan.clear();
+	scan.swap(current);
+	lastAzimuth = -1;
+	numDecoded = 0;
+	return !scan.empty();
+}
@@ -0,0 +1,113 @@
+/*
+ *  @brief: Checks the handshake of the segmentation daemon. Starts a daemon in process
+ *          and connects to it with a sealed ring, which must be accepted and labeled,
+ *          and with rings the daemon could not map safely (a regular file and a memfd
+ *          that can still shrink), which must be rejected with DAEMON_ERROR.
+ *  @file: testDaemon.cpp
+ */
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+
+#include "daemonClient.h"
+
+using namespace std;
+
+#define TEST_SLOTS  2
+#define TEST_POINTS 1000
+
+// Send a HELLO with a ring and get the answer of the daemon
+int sendHello(string socketPath, int ringFd) {
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	strcpy(address.sun_path, socketPath.c_str());
+	int sock = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+	daemonMessage message;
+	memset(&message, 0, sizeof(message));
+	message.type      = DAEMON_HELLO;
+	message.version   = DAEMON_PROTOCOL_VERSION;
+	message.numSlots  = TEST_SLOTS;
+	message.maxPoints = TEST_POINTS;
+	bool answered = sock >= 0 && connect(sock, (struct sockaddr*)&address, sizeof(address)) == 0
+	             && sendDaemonMessage(sock, message, ringFd)
+	             && receiveDaemonMessage(sock, message, NULL);
+	if (sock >= 0) close(sock);
+	return answered ? message.type : -1;
+}
+
+// Report a check
+bool check(bool passed, string name) {
+	cout << "  >> " << name << ": " << (passed ? "ok" : "FAILED") << endl;
+	return passed;
+}
+
+// Run a daemon in a directory and connect to it with every kind of ring
+bool runChecks(string directory) {
+	string socketPath = directory + "/daemon.sock";
+	groundParams params;
+	params.numLPR      = 20;
+	params.numSegments = 1;
+	params.numIters    = 3;
+	params.seedThresh  = 1.2;
+	params.distThresh  = 0.3;
+	params.method      = true;
+	params.polarGrid   = false;
+	SegmentDaemon daemon(params, true, false, 1);
+	if (!daemon.open(socketPath)) {
+		cerr << "Error: could not listen on " << socketPath << endl;
+		return false;
+	}
+	thread server(&SegmentDaemon::run, &daemon);
+	size_t ringSize = TEST_SLOTS * getDaemonSlotSize(TEST_POINTS);
+	bool passed = true;
+
+	// Sealed ring: a flat ground with a box on it
+	vector<point_XYZIRL> frame(TEST_POINTS);
+	for (int i = 0; i < TEST_POINTS; i++) {
+		memset(&frame[i], 0, sizeof(point_XYZIRL));
+		frame[i].x = 2.0 + (i % 40) * 0.5;
+		frame[i].y = -10.0 + (i / 40) * 0.8;
+		frame[i].z = i % 10 == 0 ? -0.5 : -1.73;
+	}
+	DaemonClient client;
+	vector<unsigned char> labels;
+	int numGround = -1;
+	if (check(client.connect(socketPath, TEST_SLOTS, TEST_POINTS), "sealed memfd accepted") && client.submit(frame)) {
+		numGround = client.wait(labels);
+	}
+	passed &= check(numGround == TEST_POINTS - TEST_POINTS / 10, "sealed memfd labeled");
+	client.close();
+
+	// Regular file: can not be sealed, so it could be truncated under the daemon
+	string filePath = directory + "/ring";
+	int fileFd = open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	passed &= check(fileFd >= 0 && ftruncate(fileFd, ringSize) == 0 && sendHello(socketPath, fileFd) == DAEMON_ERROR,
+	                "regular file rejected");
+	if (fileFd >= 0) close(fileFd);
+	unlink(filePath.c_str());
+
+	// Memfd without the shrink seal
+	int memFd = memfd_create("testDaemon-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+	passed &= check(memFd >= 0 && ftruncate(memFd, ringSize) == 0 && sendHello(socketPath, memFd) == DAEMON_ERROR,
+	                "unsealed memfd rejected");
+	if (memFd >= 0) close(memFd);
+
+	daemon.stop();
+	server.join();
+	return passed;
+}
+
+int main(int argc, char* argv[]) {
+	char directory[] = "/tmp/testDaemon-XXXXXX";
+	if (mkdtemp(directory) == NULL) {
+		cerr << "Error: could not create a temporary directory" << endl;
+		return 1;
+	}
+	bool passed = runChecks(directory);
+	rmdir(directory);
+	return passed ? 0 : 1;
+}